@@ -20,12 +20,24 @@
  */
 
 
+#include "qdengine/qdengine.h"
 #include "qdengine/console.h"
+#include "qdengine/qdcore/qd_condition.h"
+#include "qdengine/qdcore/qd_game_dispatcher.h"
+#include "qdengine/qdcore/qd_game_scene.h"
+#include "qdengine/qdcore/qd_memory_cache.h"
+#include "qdengine/qdcore/qd_scaled_frame_cache.h"
+#include "qdengine/qdcore/qd_trigger_chain.h"
+#include "qdengine/system/graphics/gr_dispatcher.h"
 
 namespace QDEngine {
 
 Console::Console() : GUI::Debugger() {
 	registerCmd("test",   WRAP_METHOD(Console, Cmd_test));
+	registerCmd("caches", WRAP_METHOD(Console, Cmd_caches));
+	registerCmd("regions", WRAP_METHOD(Console, Cmd_regions));
+	registerCmd("conditions", WRAP_METHOD(Console, Cmd_conditions));
+	registerCmd("triggers", WRAP_METHOD(Console, Cmd_triggers));
 }
 
 Console::~Console() {
@@ -36,4 +48,121 @@ bool Console::Cmd_test(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::Cmd_caches(int argc, const char **argv) {
+	if (argc == 2 && !strcmp(argv[1], "reset")) {
+		for (qdMemoryCache *p = qdMemoryCache::first(); p; p = p->next())
+			p->resetStats();
+	} else if (argc == 2 && !strcmp(argv[1], "clear")) {
+		for (qdMemoryCache *p = qdMemoryCache::first(); p; p = p->next())
+			p->clear();
+	} else if (argc == 4 && !strcmp(argv[1], "size")) {
+		qdMemoryCache *p = qdMemoryCache::find(argv[2]);
+		if (!p) {
+			debugPrintf("Unknown cache: %s\n", argv[2]);
+			return true;
+		}
+		p->setMemoryLimit(atoi(argv[3]) * 1024);
+	} else if (argc == 3 && !strcmp(argv[1], "step")) {
+		qdScaledFrameCache::instance().setScaleStep(float(atoi(argv[2])) / 100.0f);
+	} else if (argc != 1) {
+		debugPrintf("Usage: %s [reset | clear | size <cache> <Kbytes> | step <percent>]\n", argv[0]);
+		return true;
+	}
+
+	for (qdMemoryCache *p = qdMemoryCache::first(); p; p = p->next()) {
+		const qdMemoryCache::Stats &stats = p->stats();
+		uint32 total = stats.hits + stats.misses;
+
+		debugPrintf("%s: %u / %u Kbytes, %d entries\n", p->name(), p->memoryUsed() / 1024, p->memoryLimit() / 1024, p->entryCount());
+		debugPrintf("  hits: %u  misses: %u  evictions: %u  hit rate: %u%%\n", stats.hits, stats.misses, stats.evictions, total ? (uint32)((uint64)stats.hits * 100 / total) : 0);
+	}
+
+	debugPrintf("Scaled frame step: %d%%\n", (int)(qdScaledFrameCache::instance().scaleStep() * 100.0f + 0.5f));
+	return true;
+}
+
+bool Console::Cmd_regions(int argc, const char **argv) {
+	grDispatcher *dp = grDispatcher::instance();
+
+	if (argc == 2 && !strcmp(argv[1], "strips")) {
+		dp->set_changed_regions_mode(grDispatcher::CHANGED_REGIONS_STRIPS);
+	} else if (argc == 2 && !strcmp(argv[1], "merge")) {
+		dp->set_changed_regions_mode(grDispatcher::CHANGED_REGIONS_MERGE);
+	} else if (argc == 2 && !strcmp(argv[1], "reset")) {
+		qdGameScene::reset_redraw_stats();
+		qdGameScene::reset_pick_stats();
+	} else if (argc != 1) {
+		debugPrintf("Usage: %s [strips | merge | reset]\n", argv[0]);
+		return true;
+	}
+
+	int area = 0;
+	for (grDispatcher::region_iterator it = dp->changed_regions().begin(); it != dp->changed_regions().end(); ++it)
+		area += it->size_x() * it->size_y();
+
+	debugPrintf("Redraw regions: %s, last frame %d regions, %d pixels\n",
+	            dp->changed_regions_mode() == grDispatcher::CHANGED_REGIONS_MERGE ? "merge" : "strips", (int)dp->changed_regions().size(), area);
+	debugPrintf("  scene objects drawn: %u  skipped: %u\n", qdGameScene::redraw_objects_drawn(), qdGameScene::redraw_objects_skipped());
+	debugPrintf("  pick objects tested: %u  skipped: %u\n", qdGameScene::pick_objects_tested(), qdGameScene::pick_objects_skipped());
+	return true;
+}
+
+bool Console::Cmd_conditions(int argc, const char **argv) {
+	if (argc == 2 && !strcmp(argv[1], "reset")) {
+		qdCondition::reset_check_stats();
+	} else if (argc == 2 && !strcmp(argv[1], "on")) {
+		qdCondition::enable_result_cache(true);
+	} else if (argc == 2 && !strcmp(argv[1], "off")) {
+		qdCondition::enable_result_cache(false);
+	} else if (argc != 1) {
+		debugPrintf("Usage: %s [reset | on | off]\n", argv[0]);
+		return true;
+	}
+
+	uint32 total = qdCondition::evaluated_checks() + qdCondition::cached_checks();
+
+	debugPrintf("Condition results cache: %s\n", qdCondition::result_cache_enabled() ? "on" : "off");
+	debugPrintf("  evaluated: %u  cached: %u  cached rate: %u%%\n", qdCondition::evaluated_checks(), qdCondition::cached_checks(),
+	            total ? (uint32)((uint64)qdCondition::cached_checks() * 100 / total) : 0);
+	return true;
+}
+
+bool Console::Cmd_triggers(int argc, const char **argv) {
+	bool show_all = false;
+
+	if (argc == 2 && !strcmp(argv[1], "all")) {
+		show_all = true;
+	} else if (argc != 1) {
+		debugPrintf("Usage: %s [all]\n", argv[0]);
+		return true;
+	}
+
+	qdGameDispatcher *dp = qdGameDispatcher::get_dispatcher();
+	if (!dp) {
+		debugPrintf("No game loaded\n");
+		return true;
+	}
+
+	int total_elements = 0;
+	int total_active = 0;
+	int total_links = 0;
+
+	for (qdTriggerChainList::const_iterator it = dp->trigger_chain_list().begin(); it != dp->trigger_chain_list().end(); ++it) {
+		int elements = (*it)->elements_list().size();
+		int active = (*it)->active_elements_count();
+		int links = (*it)->active_links_count();
+
+		if (show_all || active)
+			debugPrintf("  %s: %d / %d elements active, %d links\n", (*it)->name() ? (char *)transCyrillic((*it)->name()) : "", active, elements, links);
+
+		total_elements += elements;
+		total_active += active;
+		total_links += links;
+	}
+
+	debugPrintf("Trigger chains: %d, active elements: %d / %d, active links: %d\n",
+	            (int)dp->trigger_chain_list().size(), total_active, total_elements, total_links);
+	return true;
+}
+
 } // namespace Qdengine
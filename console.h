@@ -30,6 +30,10 @@ namespace QDEngine {
 class Console : public GUI::Debugger {
 private:
 	bool Cmd_test(int argc, const char **argv);
+	bool Cmd_caches(int argc, const char **argv);
+	bool Cmd_regions(int argc, const char **argv);
+	bool Cmd_conditions(int argc, const char **argv);
+	bool Cmd_triggers(int argc, const char **argv);
 public:
 	Console();
 	~Console() override;
@@ -12,6 +12,7 @@ MODULE_OBJS = \
 	system/sound/snd_dispatcher.o \
 	system/sound/snd_sound.o \
 	system/sound/wav_sound.o \
+	system/graphics/gr_blend.o \
 	system/graphics/gr_dispatcher.o \
 	system/graphics/gr_draw_sprite_rle_z.o \
 	system/graphics/gr_draw_sprite_rle.o \
@@ -20,6 +21,7 @@ MODULE_OBJS = \
 	system/graphics/gr_font.o \
 	system/graphics/gr_screen_region.o \
 	system/graphics/gr_tile_animation.o \
+	system/graphics/gr_tile_cache.o \
 	system/graphics/gr_tile_sprite.o \
 	system/graphics/rle_compress.o \
 	system/graphics/UI_TextParser.o \
@@ -65,6 +67,7 @@ MODULE_OBJS = \
 	qdcore/qd_game_scene.o \
 	qdcore/qd_grid_zone.o \
 	qdcore/qd_grid_zone_state.o \
+	qdcore/qd_hit_mask_cache.o \
 	qdcore/qd_interface_background.o \
 	qdcore/qd_interface_button.o \
 	qdcore/qd_interface_counter.o \
@@ -79,16 +82,19 @@ MODULE_OBJS = \
 	qdcore/qd_interface_text_window.o \
 	qdcore/qd_inventory.o \
 	qdcore/qd_inventory_cell.o \
+	qdcore/qd_memory_cache.o \
 	qdcore/qd_minigame.o \
 	qdcore/qd_minigame_config.o \
 	qdcore/qd_minigame_interface.o \
 	qdcore/qd_music_track.o \
+	qdcore/qd_name_atom.o \
 	qdcore/qd_named_object.o \
 	qdcore/qd_named_object_base.o \
 	qdcore/qd_named_object_indexer.o \
 	qdcore/qd_named_object_reference.o \
 	qdcore/qd_resource.o \
 	qdcore/qd_scale_info.o \
+	qdcore/qd_scaled_frame_cache.o \
 	qdcore/qd_screen_text.o \
 	qdcore/qd_screen_text_dispatcher.o \
 	qdcore/qd_screen_text_set.o \
@@ -96,11 +102,30 @@ MODULE_OBJS = \
 	qdcore/qd_sound.o \
 	qdcore/qd_sound_info.o \
 	qdcore/qd_sprite.o \
+	qdcore/qd_sprite_contour_cache.o \
 	qdcore/qd_textdb.o \
 	qdcore/qd_trigger_chain.o \
 	qdcore/qd_trigger_element.o \
 	qdcore/qd_video.o
 
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	system/graphics/gr_blend_neon.o
+$(MODULE)/system/graphics/gr_blend_neon.o: CXXFLAGS += $(NEON_FLAGS)
+endif
+
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	system/graphics/gr_blend_sse2.o
+$(MODULE)/system/graphics/gr_blend_sse2.o: CXXFLAGS += -msse2
+endif
+
+ifdef SCUMMVM_AVX2
+MODULE_OBJS += \
+	system/graphics/gr_blend_avx2.o
+$(MODULE)/system/graphics/gr_blend_avx2.o: CXXFLAGS += -mavx2
+endif
+
 # This module can be built as a plugin
 ifeq ($(ENABLE_QDENGINE), DYNAMIC_PLUGIN)
 PLUGIN := 1
@@ -33,49 +33,49 @@ class SeekableReadStream;
 namespace QDEngine {
 
 class qdGameScene;
-typedef Std::list<qdGameScene *> qdGameSceneList;
+typedef Std::vector<qdGameScene *> qdGameSceneList;
 
 class qdGameEnd;
-typedef Std::list<qdGameEnd *> qdGameEndList;
+typedef Std::vector<qdGameEnd *> qdGameEndList;
 
 class qdVideo;
-typedef Std::list<qdVideo *> qdVideoList;
+typedef Std::vector<qdVideo *> qdVideoList;
 
 class qdTriggerChain;
-typedef Std::list<qdTriggerChain *> qdTriggerChainList;
+typedef Std::vector<qdTriggerChain *> qdTriggerChainList;
 
 class qdGameObject;
-typedef Std::list<qdGameObject *> qdGameObjectList;
+typedef Std::vector<qdGameObject *> qdGameObjectList;
 
 class qdMiniGame;
-typedef Std::list<qdMiniGame *> qdMiniGameList;
+typedef Std::vector<qdMiniGame *> qdMiniGameList;
 
 class qdCounter;
-typedef Std::list<qdCounter *> qdCounterList;
+typedef Std::vector<qdCounter *> qdCounterList;
 
 class qdGridZone;
-typedef Std::list<qdGridZone *> qdGridZoneList;
+typedef Std::vector<qdGridZone *> qdGridZoneList;
 
 class qdMusicTrack;
-typedef Std::list<qdMusicTrack *> qdMusicTrackList;
+typedef Std::vector<qdMusicTrack *> qdMusicTrackList;
 
 class qdCondition;
 typedef Std::list<qdCondition *> qdConditionList;
 
 class qdSound;
-typedef Std::list<qdSound *> qdSoundList;
+typedef Std::vector<qdSound *> qdSoundList;
 
 class qdAnimation;
-typedef Std::list<qdAnimation *> qdAnimationList;
+typedef Std::vector<qdAnimation *> qdAnimationList;
 
 class qdAnimationSet;
-typedef Std::list<qdAnimationSet *> qdAnimationSetList;
+typedef Std::vector<qdAnimationSet *> qdAnimationSetList;
 
 class qdInventory;
-typedef Std::list<qdInventory *> qdInventoryList;
+typedef Std::vector<qdInventory *> qdInventoryList;
 
 class qdTriggerChain;
-typedef Std::list<qdTriggerChain *> qdTriggerChainList;
+typedef Std::vector<qdTriggerChain *> qdTriggerChainList;
 
 class qdGameObjectState;
 class qdGameObjectStateStatic;
@@ -96,7 +96,7 @@ class qdGameDispatcher;
 typedef Std::list<Common::String> qdFileNameList;
 
 class qdFontInfo;
-typedef Std::list<qdFontInfo *> qdFontInfoList;
+typedef Std::vector<qdFontInfo *> qdFontInfoList;
 
 } // namespace QDEngine
 
@@ -30,11 +30,15 @@
 #include "qdengine/qdcore/qd_setup.h"
 #include "qdengine/system/sound/snd_dispatcher.h"
 #include "qdengine/qdcore/qd_file_manager.h"
+#include "qdengine/qdcore/qd_hit_mask_cache.h"
+#include "qdengine/qdcore/qd_scaled_frame_cache.h"
+#include "qdengine/qdcore/qd_sprite_contour_cache.h"
 #include "qdengine/qdcore/util/plaympp_api.h"
 #include "qdengine/qdcore/util/splash_screen.h"
 #include "qdengine/qdcore/util/ResourceDispatcher.h"
 #include "qdengine/qdcore/util/WinVideo.h"
 #include "qdengine/system/graphics/gr_dispatcher.h"
+#include "qdengine/system/graphics/gr_tile_animation.h"
 #include "qdengine/system/input/input_wndproc.h"
 #include "qdengine/system/input/mouse_input.h"
 #include "qdengine/system/input/keyboard_input.h"
@@ -334,6 +338,16 @@ void init_graphics() {
 		return;
 
 	qdGameConfig::get_config().set_pixel_format(grDispatcher::instance()->pixel_format());
+	grTileAnimation::setTileCacheSize(qdGameConfig::get_config().tile_cache_size() * 1024);
+	qdScaledFrameCache::instance().setScaleStep(float(qdGameConfig::get_config().scaled_frame_step()) / 100.0f);
+	qdScaledFrameCache::instance().setMemoryLimit(qdGameConfig::get_config().scaled_frame_cache_size() * 1024);
+	qdHitMaskCache::instance().setMemoryLimit(qdGameConfig::get_config().hit_mask_cache_size() * 1024);
+	qdSpriteContourCache::instance().setMemoryLimit(qdGameConfig::get_config().contour_cache_size() * 1024);
+
+	if (qdGameConfig::get_config().changed_regions_mode() == grDispatcher::CHANGED_REGIONS_STRIPS)
+		grDispatcher::instance()->set_changed_regions_mode(grDispatcher::CHANGED_REGIONS_STRIPS);
+	else
+		grDispatcher::instance()->set_changed_regions_mode(grDispatcher::CHANGED_REGIONS_MERGE);
 
 	grDispatcher::instance()->setClip();
 	grDispatcher::instance()->setClipMode(1);
@@ -39,6 +39,7 @@
 
 #include "qdengine/qdcore/qd_animation.h"
 #include "qdengine/qdcore/qd_file_manager.h"
+#include "qdengine/qdcore/qd_scaled_frame_cache.h"
 
 
 namespace QDEngine {
@@ -169,8 +170,15 @@ void qdAnimation::redraw(int x, int y, int z, float scale, int mode) const {
 	if (check_flag(QD_ANIMATION_FLAG_BLACK_FON))
 		mode |= GR_BLACK_FON;
 
-	if (const qdAnimationFrame * p = get_cur_frame(scale))
-		p->redraw(x, y, z, scale, mode);
+	if (const qdAnimationFrame * p = get_cur_frame(scale)) {
+		if (const qdAnimationFrame * sp = qdScaledFrameCache::instance().get(p, scale)) {
+			if (fabs(scale - 1.0f) < 0.01f)
+				sp->redraw(x, y, z, mode);
+			else
+				sp->redraw(x, y, z, scale, mode);
+		} else
+			p->redraw(x, y, z, scale, mode);
+	}
 }
 
 void qdAnimation::redraw_rot(int x, int y, int z, float angle, int mode) const {
@@ -231,8 +239,15 @@ void qdAnimation::draw_mask(int x, int y, int z, uint32 mask_color, int mask_alp
 	if (check_flag(QD_ANIMATION_FLAG_BLACK_FON))
 		mode |= GR_BLACK_FON;
 
-	if (const qdAnimationFrame * p = get_cur_frame(scale))
-		p->draw_mask(x, y, z, mask_color, mask_alpha, scale, mode);
+	if (const qdAnimationFrame * p = get_cur_frame(scale)) {
+		if (const qdAnimationFrame * sp = qdScaledFrameCache::instance().get(p, scale)) {
+			if (fabs(scale - 1.0f) < 0.01f)
+				sp->draw_mask(x, y, z, mask_color, mask_alpha, mode);
+			else
+				sp->draw_mask(x, y, z, mask_color, mask_alpha, scale, mode);
+		} else
+			p->draw_mask(x, y, z, mask_color, mask_alpha, scale, mode);
+	}
 }
 
 void qdAnimation::draw_mask_rot(int x, int y, int z, float angle, uint32 mask_color, int mask_alpha, int mode) const {
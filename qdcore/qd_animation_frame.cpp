@@ -23,6 +23,7 @@
 
 #include "qdengine/qd_fwd.h"
 #include "qdengine/qdcore/qd_animation_frame.h"
+#include "qdengine/qdcore/qd_scaled_frame_cache.h"
 
 
 namespace QDEngine {
@@ -37,6 +38,7 @@ qdAnimationFrame::qdAnimationFrame(const qdAnimationFrame &frm) : qdSprite(frm),
 }
 
 qdAnimationFrame::~qdAnimationFrame() {
+	qdScaledFrameCache::instance().release(this);
 	free();
 }
 
@@ -70,6 +72,7 @@ bool qdAnimationFrame::load_resources() {
 }
 
 void qdAnimationFrame::free_resources() {
+	qdScaledFrameCache::instance().release(this);
 	free();
 }
 } // namespace QDEngine
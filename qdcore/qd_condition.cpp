@@ -27,7 +27,13 @@
 #include "qdengine/parser/xml_tag_buffer.h"
 #include "qdengine/qdcore/qd_rnd.h"
 #include "qdengine/qdcore/qd_condition.h"
+#include "qdengine/qdcore/qd_counter.h"
 #include "qdengine/qdcore/qd_game_dispatcher.h"
+#include "qdengine/qdcore/qd_game_object_animated.h"
+#include "qdengine/qdcore/qd_game_object_moving.h"
+#include "qdengine/qdcore/qd_game_object_state.h"
+#include "qdengine/qdcore/qd_game_scene.h"
+#include "qdengine/qdcore/qd_grid_zone.h"
 
 namespace Common {
 class WriteStream;
@@ -38,10 +44,22 @@ namespace QDEngine {
 bool qdCondition::_successful_click = false;
 bool qdCondition::_successful_object_click = false;
 
-qdCondition::qdCondition() : _type(CONDITION_FALSE), _is_inversed(false), _is_in_group(false) {
+bool qdCondition::_result_cache_enabled = true;
+uint32 qdCondition::_evaluated_checks = 0;
+uint32 qdCondition::_cached_checks = 0;
+
+uint32 qdCondition::_current_bindings_generation = 1;
+
+qdCondition::qdCondition() : _type(CONDITION_FALSE), _is_inversed(false), _is_in_group(false),
+	_result(false), _result_stamp(0), _result_epoch(0), _dependency_count(0), _bindings_generation(0),
+	_timer_period(0.0f), _timer_rnd(0), _timer_time(0.0f), _timer_state(0) {
+	memset(_bound, 0, sizeof(_bound));
 }
 
-qdCondition::qdCondition(qdCondition::ConditionType tp) : _is_inversed(false), _is_in_group(false) {
+qdCondition::qdCondition(qdCondition::ConditionType tp) : _is_inversed(false), _is_in_group(false),
+	_result(false), _result_stamp(0), _result_epoch(0), _dependency_count(0), _bindings_generation(0),
+	_timer_period(0.0f), _timer_rnd(0), _timer_time(0.0f), _timer_state(0) {
+	memset(_bound, 0, sizeof(_bound));
 	set_type(tp);
 }
 
@@ -50,7 +68,17 @@ qdCondition::qdCondition(const qdCondition &cnd) : _type(cnd._type),
 	_data(cnd._data),
 	_objects(cnd._objects),
 	_is_inversed(cnd._is_inversed),
-	_is_in_group(false) {
+	_is_in_group(false),
+	_result(false),
+	_result_stamp(0),
+	_result_epoch(0),
+	_dependency_count(0),
+	_bindings_generation(0),
+	_timer_period(cnd._timer_period),
+	_timer_rnd(cnd._timer_rnd),
+	_timer_time(cnd._timer_time),
+	_timer_state(cnd._timer_state) {
+	memset(_bound, 0, sizeof(_bound));
 }
 
 qdCondition &qdCondition::operator = (const qdCondition &cnd) {
@@ -64,6 +92,14 @@ qdCondition &qdCondition::operator = (const qdCondition &cnd) {
 
 	_is_inversed = cnd._is_inversed;
 
+	_timer_period = cnd._timer_period;
+	_timer_rnd = cnd._timer_rnd;
+	_timer_time = cnd._timer_time;
+	_timer_state = cnd._timer_state;
+
+	drop_result();
+	_bindings_generation = 0;
+
 	return *this;
 }
 
@@ -72,6 +108,8 @@ qdCondition::~qdCondition() {
 
 void qdCondition::set_type(ConditionType tp) {
 	_type = tp;
+	drop_result();
+	_bindings_generation = 0;
 
 	switch (_type) {
 	case CONDITION_TRUE:
@@ -269,21 +307,33 @@ void qdCondition::set_type(ConditionType tp) {
 		_objects.resize(2);
 		break;
 	}
+
+	update_timer_data();
 }
 
 bool qdCondition::put_value(int idx, const char *str) {
 	assert(idx >= 0 && idx < _data.size());
+	drop_result();
+	_bindings_generation = 0;
 	return _data[idx].put_string(str);
 }
 
 bool qdCondition::put_value(int idx, int val, int val_index) {
 	assert(idx >= 0 && idx < _data.size());
-	return _data[idx].put_int(val, val_index);
+	drop_result();
+
+	bool result = _data[idx].put_int(val, val_index);
+	update_timer_data();
+	return result;
 }
 
 bool qdCondition::put_value(int idx, float val, int val_index) {
 	assert(idx >= 0 && idx < _data.size());
-	return _data[idx].put_float(val, val_index);
+	drop_result();
+
+	bool result = _data[idx].put_float(val, val_index);
+	update_timer_data();
+	return result;
 }
 
 bool qdCondition::get_value(int idx, const char *&str) const {
@@ -312,6 +362,8 @@ bool qdCondition::get_value(int idx, float &val, int val_index) const {
 }
 
 bool qdCondition::load_script(const xml::tag *p) {
+	drop_result();
+
 	int data_idx = 0;
 	for (xml::tag::subtag_iterator it = p->subtags_begin(); it != p->subtags_end(); ++it) {
 		switch (it->ID()) {
@@ -337,6 +389,10 @@ bool qdCondition::load_script(const xml::tag *p) {
 			break;
 		}
 	}
+
+	_bindings_generation = 0;
+	update_timer_data();
+
 	return true;
 }
 
@@ -373,43 +429,27 @@ bool qdCondition::save_script(Common::WriteStream &fh, int indent) const {
 void qdCondition::quant(float dt) {
 	debugC(9, kDebugQuant, "qdCondition::quant(%f)", dt);
 	if (_type == CONDITION_TIMER) {
-		float period, timer;
-		if (!get_value(TIMER_PERIOD, period, 0)) return;
-		if (!get_value(TIMER_PERIOD, timer, 1)) return;
+		_timer_time += dt;
 
-		timer += dt;
-
-		put_value(TIMER_PERIOD, timer, 1);
-
-		if (timer >= period) {
+		if (_timer_time >= _timer_period) {
 			debugC(3, kDebugQuant, "qdCondition::quant() timer >= period");
-			timer -= period;
-			put_value(TIMER_PERIOD, timer, 1);
-
-			int rnd;
-			if (!get_value(TIMER_RND, rnd)) return;
+			_timer_time -= _timer_period;
 
 			int state = 1;
-			if (rnd && qd_rnd(100 - rnd))
+			if (_timer_rnd && qd_rnd(100 - _timer_rnd))
 				state = 0;
 
-			put_value(TIMER_RND, state, 1);
+			_timer_state = state;
 		} else
-			put_value(TIMER_RND, 0, 1);
+			_timer_state = 0;
 	}
 }
 
 bool qdCondition::load_data(Common::SeekableReadStream &fh, int save_version) {
 	debugC(5, kDebugSave, "      qdCondition::load_data(): before %ld", fh.pos());
 	if (_type == CONDITION_TIMER) {
-		int state;
-		float timer;
-
-		timer = fh.readFloatLE();
-		state = fh.readSint32LE();
-
-		if (!put_value(TIMER_PERIOD, timer, 1)) return false;
-		if (!put_value(TIMER_RND, state, 1)) return false;
+		_timer_time = fh.readFloatLE();
+		_timer_state = fh.readSint32LE();
 	}
 
 	debugC(5, kDebugSave, "      qdCondition::load_data(): after %ld", fh.pos());
@@ -419,18 +459,8 @@ bool qdCondition::load_data(Common::SeekableReadStream &fh, int save_version) {
 bool qdCondition::save_data(Common::WriteStream &fh) const {
 	debugC(5, kDebugSave, "      qdCondition::save_data(): before %ld", fh.pos());
 	if (_type == CONDITION_TIMER) {
-		float timer;
-		if (!get_value(TIMER_PERIOD, timer, 1)) {
-			return false;
-		}
-
-		int state;
-		if (!get_value(TIMER_RND, state, 1)) {
-			return false;
-		}
-
-		fh.writeFloatLE(timer);
-		fh.writeSint32LE(state);
+		fh.writeFloatLE(_timer_time);
+		fh.writeSint32LE(_timer_state);
 	}
 
 	debugC(5, kDebugSave, "      qdCondition::save_data(): after %ld", fh.pos());
@@ -439,11 +469,19 @@ bool qdCondition::save_data(Common::WriteStream &fh) const {
 
 bool qdCondition::check() {
 	bool result = false;
-	if (qdGameDispatcher * dp = qdGameDispatcher::get_dispatcher()) {
+	if (_result_cache_enabled && is_result_valid()) {
+		result = _result;
+		_cached_checks++;
+	} else if (qdGameDispatcher * dp = qdGameDispatcher::get_dispatcher()) {
 		if (dp->check_condition(this))
 			result = !_is_inversed;
 		else
 			result = _is_inversed;
+
+		_evaluated_checks++;
+
+		if (_result_cache_enabled)
+			store_result(result);
 	}
 
 	if (result) {
@@ -459,6 +497,8 @@ bool qdCondition::check() {
 bool qdCondition::put_object(int idx, const qdNamedObject *obj) {
 	assert(idx >= 0 && idx < _objects.size());
 	_objects[idx].set_object(obj);
+	drop_result();
+	_bindings_generation = 0;
 	return true;
 }
 
@@ -475,10 +515,240 @@ const qdNamedObject *qdCondition::get_object(int idx) {
 
 
 bool qdCondition::init() {
+	drop_result();
+
 	if (_type == CONDITION_TIMER) {
-		if (!put_value(TIMER_PERIOD, 0.0f, 1)) return false;
-		if (!put_value(TIMER_RND, 0, 1)) return false;
+		_timer_time = 0.0f;
+		_timer_state = 0;
 	}
 	return true;
 }
+
+void qdCondition::update_timer_data() {
+	if (_type != CONDITION_TIMER || _data.size() < 2)
+		return;
+
+	_timer_period = _data[TIMER_PERIOD].get_float(0);
+	_timer_time = _data[TIMER_PERIOD].get_float(1);
+	_timer_rnd = _data[TIMER_RND].get_int(0);
+	_timer_state = _data[TIMER_RND].get_int(1);
+}
+
+//! Ищет у объекта состояние с именем state_name.
+/**
+Возвращает NULL, если такого состояния нет или имя неоднозначно - совпадает
+без учета регистра с именами нескольких состояний или с точностью до регистра;
+тогда при проверке условия состояние ищется по имени.
+*/
+static const qdGameObjectState *find_unique_state(const qdGameObjectAnimated *obj, const char *state_name) {
+	qdNameAtom atom = qdNameAtomTable::instance().find(state_name);
+	if (!atom) return NULL;
+
+	const qdGameObjectState *state = NULL;
+	for (auto &it : obj->state_vector()) {
+		if (it->name_atom() == atom) {
+			if (state || strcmp(it->name(), state_name))
+				return NULL;
+			state = it;
+		}
+	}
+
+	return state;
+}
+
+void qdCondition::bind_object(int idx, const qdNamedObject *p) {
+	BoundObject &obj = _bound[idx];
+
+	obj.object = p;
+	obj.game_object = dynamic_cast<const qdGameObject *>(p);
+	obj.animated_object = dynamic_cast<const qdGameObjectAnimated *>(p);
+	obj.personage = dynamic_cast<const qdGameObjectMoving *>(p);
+	obj.state = dynamic_cast<const qdGameObjectState *>(p);
+	obj.zone = dynamic_cast<const qdGridZone *>(p);
+	obj.counter = dynamic_cast<const qdCounter *>(p);
+}
+
+const qdNamedObject *qdCondition::find_object(int idx, BindMode mode, bool by_name, bool by_owner) {
+	if (const qdNamedObject *p = get_object(idx)) {
+		switch (mode) {
+		case BIND_ANY:
+			return p;
+		case BIND_GAME_OBJECT:
+			if (dynamic_cast<const qdGameObject *>(p))
+				return p;
+			break;
+		case BIND_PERSONAGE:
+			if (dynamic_cast<const qdGameObjectMoving *>(p))
+				return p;
+			break;
+		}
+	}
+
+	if (by_name) {
+		const char *object_name;
+		if (get_value(idx, object_name) && strlen(object_name)) {
+			if (qdGameDispatcher *dp = qdGameDispatcher::get_dispatcher())
+				return dp->get_object(object_name);
+			return NULL;
+		}
+	}
+
+	if (by_owner && _owner)
+		return _owner->owner();
+
+	return NULL;
+}
+
+void qdCondition::compile() {
+	memset(_bound, 0, sizeof(_bound));
+	_bindings_generation = _current_bindings_generation;
+
+	for (int i = 0; i < _objects.size() && i < MAX_BOUND_OBJECTS; i++)
+		bind_object(i, get_object(i));
+
+	qdGameScene *scene = NULL;
+	if (qdGameDispatcher *dp = qdGameDispatcher::get_dispatcher())
+		scene = dp->get_active_scene();
+
+	switch (_type) {
+	case CONDITION_MOUSE_CLICK:
+		bind_object(OBJECT_NAME, find_object(OBJECT_NAME, BIND_ANY, true, true));
+		break;
+	case CONDITION_MOUSE_OBJECT_CLICK:
+		bind_object(OBJECT_NAME, find_object(OBJECT_NAME, BIND_ANY, true, true));
+		bind_object(MOUSE_OBJECT_NAME, find_object(MOUSE_OBJECT_NAME, BIND_GAME_OBJECT, true, false));
+		break;
+	case CONDITION_OBJECT_IN_ZONE:
+		bind_object(OBJECT_NAME, find_object(OBJECT_NAME, BIND_GAME_OBJECT, true, true));
+		if (!get_object(ZONE_NAME)) {
+			const char *zone_name;
+			if (scene && get_value(ZONE_NAME, zone_name))
+				bind_object(ZONE_NAME, scene->get_grid_zone(zone_name));
+		}
+		break;
+	case CONDITION_PERSONAGE_WALK_DIRECTION:
+	case CONDITION_PERSONAGE_STATIC_DIRECTION:
+	case CONDITION_PERSONAGE_ACTIVE:
+		bind_object(PERSONAGE_NAME, find_object(PERSONAGE_NAME, BIND_PERSONAGE, true, true));
+		break;
+	case CONDITION_OBJECT_STATE:
+	case CONDITION_OBJECT_STATE_WAITING:
+	case CONDITION_OBJECT_STATE_ANIMATION_PHASE:
+	case CONDITION_OBJECT_PREV_STATE:
+	case CONDITION_OBJECT_STATE_WAS_ACTIVATED:
+		if (_type == CONDITION_OBJECT_STATE_WAS_ACTIVATED)
+			bind_object(OBJECT_NAME, find_object(OBJECT_NAME, BIND_ANY, true, true));
+		else
+			bind_object(OBJECT_NAME, find_object(OBJECT_NAME, BIND_GAME_OBJECT, true, true));
+
+		if (!_bound[OBJECT_STATE_NAME].state) {
+			const qdGameObjectState *state = NULL;
+
+			const char *state_name;
+			if (_bound[OBJECT_NAME].animated_object && get_value(OBJECT_STATE_NAME, state_name) && strlen(state_name))
+				state = find_unique_state(_bound[OBJECT_NAME].animated_object, state_name);
+
+			bind_object(OBJECT_STATE_NAME, state);
+		}
+		break;
+	case CONDITION_OBJECTS_DISTANCE:
+		bind_object(OBJECT_NAME, find_object(OBJECT_NAME, BIND_GAME_OBJECT, true, false));
+		bind_object(OBJECT2_NAME, find_object(OBJECT2_NAME, BIND_GAME_OBJECT, true, false));
+		break;
+	case CONDITION_MOUSE_ZONE_CLICK:
+	case CONDITION_MOUSE_OBJECT_ZONE_CLICK:
+		if (!_bound[CLICK_ZONE_NAME].zone) {
+			const qdGridZone *zone = NULL;
+
+			const char *zone_name;
+			if (scene && get_value(CLICK_ZONE_NAME, zone_name))
+				zone = scene->get_grid_zone(zone_name);
+
+			bind_object(CLICK_ZONE_NAME, zone);
+		}
+		if (_type == CONDITION_MOUSE_OBJECT_ZONE_CLICK)
+			bind_object(MOUSE_OBJECT_NAME, find_object(MOUSE_OBJECT_NAME, BIND_GAME_OBJECT, true, false));
+		break;
+	case CONDITION_MOUSE_HOVER:
+	case CONDITION_MOUSE_OBJECT_HOVER:
+		bind_object(OBJECT_NAME, find_object(OBJECT_NAME, BIND_ANY, false, true));
+		break;
+	case CONDITION_OBJECT_IS_CLOSER:
+		bind_object(0, find_object(0, BIND_GAME_OBJECT, false, true));
+		break;
+	default:
+		break;
+	}
+}
+
+qdCondition::DependencyType qdCondition::dependency_type() const {
+	switch (_type) {
+	case CONDITION_TRUE:
+	case CONDITION_FALSE:
+	case CONDITION_MINIGAME_STATE:
+		return DEPENDS_ON_NOTHING;
+	case CONDITION_OBJECT_STATE:
+	case CONDITION_OBJECT_STATE_WAS_ACTIVATED:
+	case CONDITION_OBJECT_STATE_WAITING:
+	case CONDITION_OBJECT_PREV_STATE:
+	case CONDITION_OBJECT_HIDDEN:
+	case CONDITION_COUNTER_GREATER_THAN_VALUE:
+	case CONDITION_COUNTER_LESS_THAN_VALUE:
+	case CONDITION_COUNTER_GREATER_THAN_COUNTER:
+	case CONDITION_COUNTER_IN_INTERVAL:
+		return DEPENDS_ON_OBJECTS;
+	default:
+		return DEPENDS_ON_FRAME;
+	}
+}
+
+bool qdCondition::is_result_valid() const {
+	if (_result_epoch != qdNamedObject::change_epoch())
+		return false;
+
+	for (int i = 0; i < _dependency_count; i++) {
+		if (_dependencies[i]->change_stamp() > _result_stamp)
+			return false;
+	}
+
+	return true;
+}
+
+void qdCondition::store_result(bool result) {
+	drop_result();
+	_dependency_count = 0;
+
+	switch (dependency_type()) {
+	case DEPENDS_ON_NOTHING:
+		break;
+	case DEPENDS_ON_OBJECTS:
+		// результат запоминается, только если все объекты условия найдены
+		// при компиляции, иначе при проверке используется поиск по имени
+		if (!is_compiled() || _objects.size() > MAX_BOUND_OBJECTS)
+			return;
+
+		for (int i = 0; i < _objects.size(); i++) {
+			const qdNamedObject *p = _bound[i].object;
+			if (!p) return;
+			_dependencies[_dependency_count++] = p;
+		}
+
+		// от текущего состояния объекта зависит его видимость
+		if (!_objects.empty()) {
+			const qdNamedObject *p = _bound[0].object;
+			int type = p->named_object_type();
+			if (type == QD_NAMED_OBJECT_ANIMATED_OBJ || type == QD_NAMED_OBJECT_MOVING_OBJ || type == QD_NAMED_OBJECT_MOUSE_OBJ) {
+				if (const qdGameObjectState *sp = static_cast<const qdGameObjectAnimated *>(p)->get_cur_state())
+					_dependencies[_dependency_count++] = sp;
+			}
+		}
+		break;
+	case DEPENDS_ON_FRAME:
+		return;
+	}
+
+	_result = result;
+	_result_stamp = qdNamedObject::change_counter();
+	_result_epoch = qdNamedObject::change_epoch();
+}
 } // namespace QDEngine
@@ -33,6 +33,12 @@ class WriteStream;
 
 namespace QDEngine {
 
+class qdCounter;
+class qdGameObject;
+class qdGameObjectAnimated;
+class qdGameObjectMoving;
+class qdGameObjectState;
+class qdGridZone;
 
 //! Условие.
 /**
@@ -480,6 +486,16 @@ public:
 		STATE_TIME = 2
 	};
 
+	//! От чего зависит результат проверки условия.
+	enum DependencyType {
+		//! результат постоянный
+		DEPENDS_ON_NOTHING,
+		//! результат зависит только от объектов условия - счетчиков, объектов и их состояний
+		DEPENDS_ON_OBJECTS,
+		//! результат может поменяться в любой квант - мышь, клавиатура, таймеры, положение объектов
+		DEPENDS_ON_FRAME
+	};
+
 	qdCondition();
 	qdCondition(ConditionType tp);
 	qdCondition(const qdCondition &cnd);
@@ -533,15 +549,78 @@ public:
 	//! Инициализация условия, вызывается при старте и перезапуске игры.
 	bool init();
 
+	//! Компиляция условия.
+	/**
+	Находит объекты условия - по ссылкам, по именам в активной сцене или
+	через владельца условия, так же, как это делается при проверке, - и
+	запоминает их в типизированном виде. Проверка скомпилированного
+	условия обходится без поиска по именам и dynamic_cast.
+
+	Результат зависит от активной сцены и сбрасывается invalidate_bindings().
+	*/
+	void compile();
+	//! Возвращает true, если условие скомпилировано для текущей сцены.
+	bool is_compiled() const {
+		return _bindings_generation == _current_bindings_generation;
+	}
+	//! Сбрасывает результаты компиляции всех условий.
+	static void invalidate_bindings() {
+		_current_bindings_generation++;
+	}
+
+	//! Объект условия с индексом idx, найденный при компиляции.
+	const qdNamedObject *bound_object(int idx) const {
+		return _bound[idx].object;
+	}
+	//! Объект условия как qdGameObject, NULL - если объект другого типа.
+	const qdGameObject *bound_game_object(int idx) const {
+		return _bound[idx].game_object;
+	}
+	//! Объект условия как qdGameObjectAnimated, NULL - если объект другого типа.
+	const qdGameObjectAnimated *bound_animated_object(int idx) const {
+		return _bound[idx].animated_object;
+	}
+	//! Объект условия как qdGameObjectMoving, NULL - если объект другого типа.
+	const qdGameObjectMoving *bound_personage(int idx) const {
+		return _bound[idx].personage;
+	}
+	//! Объект условия как qdGameObjectState, NULL - если объект другого типа.
+	const qdGameObjectState *bound_state(int idx) const {
+		return _bound[idx].state;
+	}
+	//! Объект условия как qdGridZone, NULL - если объект другого типа.
+	const qdGridZone *bound_zone(int idx) const {
+		return _bound[idx].zone;
+	}
+	//! Объект условия как qdCounter, NULL - если объект другого типа.
+	const qdCounter *bound_counter(int idx) const {
+		return _bound[idx].counter;
+	}
+
+	//! Возвращает true, если сработал таймер (для CONDITION_TIMER).
+	bool timer_state() const {
+		return _timer_state != 0;
+	}
+
 	bool is_inversed() const {
 		return _is_inversed;
 	}
 	void inverse(bool inverse_mode = true) {
 		_is_inversed = inverse_mode;
+		drop_result();
 	}
 
+	//! Проверка условия.
+	/**
+	Результат условий, зависящих только от объектов (DEPENDS_ON_OBJECTS),
+	запоминается и используется повторно, пока не изменится ни один
+	из объектов, см. qdNamedObject::touch().
+	*/
 	bool check();
 
+	//! Возвращает, от чего зависит результат проверки условия.
+	DependencyType dependency_type() const;
+
 	bool is_in_group() const {
 		return _is_in_group;
 	}
@@ -562,6 +641,26 @@ public:
 		_successful_click = _successful_object_click = false;
 	}
 
+	//! Включает/выключает повторное использование результатов проверки.
+	static void enable_result_cache(bool state) {
+		_result_cache_enabled = state;
+	}
+	static bool result_cache_enabled() {
+		return _result_cache_enabled;
+	}
+
+	//! Количество проверок, для которых условие вычислялось заново.
+	static uint32 evaluated_checks() {
+		return _evaluated_checks;
+	}
+	//! Количество проверок, для которых взят запомненный результат.
+	static uint32 cached_checks() {
+		return _cached_checks;
+	}
+	static void reset_check_stats() {
+		_evaluated_checks = _cached_checks = 0;
+	}
+
 private:
 
 	ConditionType _type;
@@ -580,6 +679,68 @@ private:
 	static bool _successful_click;
 	static bool _successful_object_click;
 
+	enum {
+		MAX_DEPENDENCIES = 4,
+		MAX_BOUND_OBJECTS = 3
+	};
+
+	//! Запомненный результат проверки.
+	bool _result;
+	//! Значение qdNamedObject::change_counter() на момент проверки.
+	uint32 _result_stamp;
+	//! Эпоха изменений на момент проверки, 0 - результата нет.
+	uint32 _result_epoch;
+
+	//! Объекты, от которых зависит запомненный результат.
+	const qdNamedObject *_dependencies[MAX_DEPENDENCIES];
+	int _dependency_count;
+
+	static bool _result_cache_enabled;
+	static uint32 _evaluated_checks;
+	static uint32 _cached_checks;
+
+	void drop_result() {
+		_result_epoch = 0;
+	}
+	bool is_result_valid() const;
+	void store_result(bool result);
+
+	//! Объект условия, найденный при компиляции.
+	struct BoundObject {
+		const qdNamedObject *object;
+		const qdGameObject *game_object;
+		const qdGameObjectAnimated *animated_object;
+		const qdGameObjectMoving *personage;
+		const qdGameObjectState *state;
+		const qdGridZone *zone;
+		const qdCounter *counter;
+	};
+
+	//! Объекты условия, найденные при компиляции.
+	BoundObject _bound[MAX_BOUND_OBJECTS];
+	//! Поколение компиляции, для которого найдены объекты.
+	uint32 _bindings_generation;
+
+	static uint32 _current_bindings_generation;
+
+	//! Данные CONDITION_TIMER - период и вероятность срабатывания.
+	float _timer_period;
+	int _timer_rnd;
+	//! Текущее время и состояние таймера.
+	float _timer_time;
+	int _timer_state;
+
+	//! Требования к типу объекта при поиске объекта условия.
+	enum BindMode {
+		BIND_ANY,
+		BIND_GAME_OBJECT,
+		BIND_PERSONAGE
+	};
+
+	void bind_object(int idx, const qdNamedObject *p);
+	const qdNamedObject *find_object(int idx, BindMode mode, bool by_name, bool by_owner);
+	void update_timer_data();
+
 	bool init_data(int data_index, qdConditionData::data_t data_type, int data_size = 0) {
 		assert(data_index >= 0 && data_index < _data.size());
 
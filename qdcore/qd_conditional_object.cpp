@@ -197,6 +197,11 @@ void qdConditionalObject::conditions_quant(float dt) {
 	}
 }
 
+void qdConditionalObject::compile_conditions() {
+	for (auto &it : _conditions)
+		it.compile();
+}
+
 bool qdConditionalObject::load_data(Common::SeekableReadStream &fh, int save_version) {
 	debugC(4, kDebugSave, "    qdConditionalObject::load_data(): before %ld", fh.pos());
 	if (!qdNamedObject::load_data(fh, save_version))
@@ -107,6 +107,8 @@ public:
 
 	//! Обсчет логики условий, dt - время в секундах.
 	void conditions_quant(float dt);
+	//! Компиляция условий, см. qdCondition::compile().
+	void compile_conditions();
 
 	//! Инициализация объекта, вызывается при старте и перезепуске игры.
 	virtual bool init();
@@ -137,6 +137,7 @@ qdCounter::~qdCounter() {
 }
 
 void qdCounter::set_value(int value) {
+	int old_value = _value;
 	_value = value;
 
 	if (_value_limit > 0 && _value >= _value_limit)
@@ -144,9 +145,13 @@ void qdCounter::set_value(int value) {
 
 	if (check_flag(POSITIVE_VALUE) && _value < 0)
 		_value = 0;
+
+	if (_value != old_value)
+		touch();
 }
 
 void qdCounter::add_value(int value_delta) {
+	int old_value = _value;
 	_value += value_delta;
 
 	if (_value_limit > 0 && _value >= _value_limit)
@@ -154,6 +159,9 @@ void qdCounter::add_value(int value_delta) {
 
 	if (check_flag(POSITIVE_VALUE) && _value < 0)
 		_value = 0;
+
+	if (_value != old_value)
+		touch();
 }
 
 bool qdCounter::add_element(const qdGameObjectState *p, bool inc_value) {
@@ -193,6 +201,7 @@ void qdCounter::quant() {
 		}
 	}
 
+	int old_value = _value;
 	_value += value_change;
 
 	if (_value_limit > 0 && _value >= _value_limit)
@@ -200,6 +209,9 @@ void qdCounter::quant() {
 
 	if (check_flag(POSITIVE_VALUE) && _value < 0)
 		_value = 0;
+
+	if (_value != old_value)
+		touch();
 }
 
 bool qdCounter::load_script(const xml::tag *p) {
@@ -273,6 +285,7 @@ bool qdCounter::load_data(Common::SeekableReadStream &fh, int save_version) {
 	debugC(3, kDebugSave, "  qdCounter::load_data(): before %ld", fh.pos());
 	int sz;
 	_value = fh.readSint32LE();
+	touch();
 	sz = fh.readSint32LE();
 
 	if (sz != _elements.size())
@@ -303,6 +316,7 @@ void qdCounter::init() {
 		it->init();
 
 	_value = 0;
+	touch();
 }
 
 } // namespace QDEngine
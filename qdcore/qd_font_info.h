@@ -88,7 +88,7 @@ private:
 	grFont *_font;
 };
 
-typedef Std::list<qdFontInfo *> qdFontInfoList;
+typedef Std::vector<qdFontInfo *> qdFontInfoList;
 
 
 } // namespace QDEngine
@@ -97,7 +97,13 @@ qdGameDispatcher::qdGameDispatcher() : _is_paused(false),
 	_scene_saved(false),
 	_mouse_click_state(NULL),
 	_mouse_click_obj(NULL),
-	_game_end(NULL) {
+	_game_end(NULL),
+	_scroll_delta(0, 0),
+	_scroll_ghost_regions(false),
+	_scroll_flush(false),
+	_fade_frame(NULL),
+	_fade_frame_ready(false),
+	_fade_frame_grabbed(false) {
 	_timer = 0;
 	_default_font = 0;
 
@@ -147,6 +153,8 @@ qdGameDispatcher::~qdGameDispatcher() {
 	delete _mouse_obj;
 	delete _mouse_animation;
 
+	delete _fade_frame;
+
 	_trigger_chains.clear();
 
 	if (_dispatcher == this)
@@ -281,6 +289,7 @@ void qdGameDispatcher::quant(float dt) {
 			if (_fade_timer >= _fade_duration && !check_flag(FADE_OUT_FLAG)) {
 				_fade_timer = _fade_duration;
 				drop_flag(FADE_IN_FLAG | FADE_OUT_FLAG);
+				_fade_frame_ready = false;
 			}
 
 			toggle_full_redraw();
@@ -675,23 +684,48 @@ qdAnimationSet *qdGameDispatcher::get_animation_set(const char *name) {
 void qdGameDispatcher::pre_redraw() {
 	grDispatcher::instance()->clear_changes_mask();
 
+	_scroll_flush = false;
+	if (need_full_redraw())
+		_scroll_delta = Vect2i(0, 0);
+	else if (_scroll_delta.x || _scroll_delta.y)
+		apply_scroll();
+
 	if (_cur_scene)
 		_cur_scene->pre_redraw();
 
+	// Всё, что выводится в экранных координатах, сдвинулось вместе с изображением,
+	// так что вместе с их областями перерисовываются и сдвинутые копии.
+	_scroll_ghost_regions = _scroll_flush;
+
+	if (_scroll_flush) {
+		_interface_dispatcher.toggle_full_redraw();
+
+		add_redraw_region(_mouse_obj->last_screen_region());
+		add_redraw_region(_mouse_obj->screen_region());
+		if (const qdGameObjectAnimated *p = _mouse_obj->object()) {
+			add_redraw_region(p->last_screen_region());
+			add_redraw_region(p->screen_region());
+		}
+
+		add_redraw_region(_screen_texts.screen_region());
+	}
+
 	_interface_dispatcher.pre_redraw();
 	_mouse_obj->pre_redraw();
 	_screen_texts.pre_redraw();
 
 	if (!need_full_redraw()) {
 		if (_cur_inventory) {
-//			_cur_inventory->toggle_redraw(true);
+			if (_scroll_flush)
+				_cur_inventory->toggle_redraw(true);
 			_cur_inventory->pre_redraw();
 		}
 
 		if (_cur_scene) {
 			for (qdInventoryList::const_iterator it = inventory_list().begin(); it != inventory_list().end(); ++it) {
 				if (*it != _cur_inventory && (*it)->check_flag(qdInventory::INV_VISIBLE_WHEN_INACTIVE) && _cur_scene->need_to_redraw_inventory((*it)->name())) {
-//					(*it)->toggle_redraw(true);
+					if (_scroll_flush)
+						(*it)->toggle_redraw(true);
 					(*it)->pre_redraw();
 				}
 			}
@@ -699,9 +733,65 @@ void qdGameDispatcher::pre_redraw() {
 	} else
 		add_redraw_region(grScreenRegion(grDispatcher::instance()->get_SizeX() / 2, grDispatcher::instance()->get_SizeY() / 2, grDispatcher::instance()->get_SizeX(), grDispatcher::instance()->get_SizeY()));
 
+	_scroll_ghost_regions = false;
+	_scroll_delta = Vect2i(0, 0);
+
 	grDispatcher::instance()->build_changed_regions();
 }
 
+void qdGameDispatcher::scroll_screen(const Vect2i &delta) {
+	if (need_full_redraw())
+		return;
+
+	_scroll_delta += delta;
+
+	bool full_redraw = !qdGameConfig::get_config().scroll_redraw() || _interface_dispatcher.is_active();
+
+	if (_cur_scene && _cur_scene->check_flag(qdGameScene::CYCLE_X | qdGameScene::CYCLE_Y))
+		full_redraw = true;
+
+	// при сдвиге больше чем на пол-экрана проще перерисовать всё
+	if (abs(_scroll_delta.x) * 2 > grDispatcher::instance()->get_SizeX() || abs(_scroll_delta.y) * 2 > grDispatcher::instance()->get_SizeY())
+		full_redraw = true;
+
+	if (full_redraw) {
+		_scroll_delta = Vect2i(0, 0);
+		toggle_full_redraw();
+	}
+}
+
+void qdGameDispatcher::apply_scroll() {
+	const int sx = grDispatcher::instance()->get_SizeX();
+	const int sy = grDispatcher::instance()->get_SizeY();
+
+	const int dx = _scroll_delta.x;
+	const int dy = _scroll_delta.y;
+
+	debugC(3, kDebugGraphics, "qdGameDispatcher::apply_scroll(): %d %d", dx, dy);
+
+	grDispatcher::instance()->scroll(dx, dy);
+
+	// открывшиеся полосы задаются левым верхним углом и размером,
+	// размер округляется до четного, чтобы полоса в пиксел не пропадала
+	// (grScreenRegion покрывает от x - size / 2 до x + size / 2)
+	if (dx) {
+		int x0 = (dx > 0) ? 0 : sx + dx;
+		int width = (abs(dx) + 1) & ~1;
+		add_redraw_region(grScreenRegion(x0 + width / 2, sy / 2, width, sy));
+	}
+
+	if (dy) {
+		int y0 = (dy > 0) ? 0 : sy + dy;
+		int height = (abs(dy) + 1) & ~1;
+		add_redraw_region(grScreenRegion(sx / 2, y0 + height / 2, sx, height));
+	}
+
+	if (_cur_scene)
+		_cur_scene->scroll_screen(dx, dy);
+
+	_scroll_flush = true;
+}
+
 void qdGameDispatcher::post_redraw() {
 	if (_cur_scene)
 		_cur_scene->post_redraw();
@@ -736,7 +826,16 @@ void qdGameDispatcher::redraw() {
 					redraw(*it);
 			}
 
-			grDispatcher::instance()->flushChanges();
+			// запомненный кадр годится для затемнения, только если перерисовывался весь экран
+			if (_fade_frame_grabbed) {
+				_fade_frame_ready = need_full_redraw();
+				_fade_frame_grabbed = false;
+			}
+
+			if (_scroll_flush)
+				grDispatcher::instance()->flush();
+			else
+				grDispatcher::instance()->flushChanges();
 #else
 			redraw(grScreenRegion(grDispatcher::instance()->get_SizeX() / 2, grDispatcher::instance()->get_SizeY() / 2, grDispatcher::instance()->get_SizeX(), grDispatcher::instance()->get_SizeY()));
 
@@ -776,22 +875,26 @@ void qdGameDispatcher::redraw(const grScreenRegion &reg) {
 
 void qdGameDispatcher::redraw_scene(bool draw_interface) {
 	if (_cur_scene) {
-		_cur_scene->redraw();
+		bool fade = check_flag(FADE_IN_FLAG | FADE_OUT_FLAG);
 
-		if (draw_interface) {
-			_interface_dispatcher.redraw();
-			if (_cur_inventory) _cur_inventory->redraw();
+		int left, top, right, bottom;
+		grDispatcher::instance()->getClip(left, top, right, bottom);
 
-			for (qdInventoryList::const_iterator it = inventory_list().begin(); it != inventory_list().end(); ++it) {
-				if (*it != _cur_inventory && (*it)->check_flag(qdInventory::INV_VISIBLE_WHEN_INACTIVE) && _cur_scene->need_to_redraw_inventory((*it)->name()))
-					(*it)->redraw(0, 0, true);
+		if (fade && _fade_frame_ready) {
+			grDispatcher::instance()->put_layer(_fade_frame, left, top, right - left, bottom - top);
+		} else {
+			redraw_scene_layers(draw_interface);
+
+			if (fade && qdGameConfig::get_config().fade_cached_frame()) {
+				if (!_fade_frame)
+					_fade_frame = grDispatcher::instance()->create_layer();
+
+				grDispatcher::instance()->grab_layer(_fade_frame, left, top, right - left, bottom - top);
+				_fade_frame_grabbed = true;
 			}
 		}
 
-		_screen_texts.redraw();
-		_cur_scene->debug_redraw();
-
-		if (check_flag(FADE_IN_FLAG | FADE_OUT_FLAG)) {
+		if (fade) {
 			float phase = _fade_timer / _fade_duration;
 			if (phase > 1.f) phase = 1.f;
 
@@ -806,6 +909,23 @@ void qdGameDispatcher::redraw_scene(bool draw_interface) {
 	}
 }
 
+void qdGameDispatcher::redraw_scene_layers(bool draw_interface) {
+	_cur_scene->redraw();
+
+	if (draw_interface) {
+		_interface_dispatcher.redraw();
+		if (_cur_inventory) _cur_inventory->redraw();
+
+		for (qdInventoryList::const_iterator it = inventory_list().begin(); it != inventory_list().end(); ++it) {
+			if (*it != _cur_inventory && (*it)->check_flag(qdInventory::INV_VISIBLE_WHEN_INACTIVE) && _cur_scene->need_to_redraw_inventory((*it)->name()))
+				(*it)->redraw(0, 0, true);
+		}
+	}
+
+	_screen_texts.redraw();
+	_cur_scene->debug_redraw();
+}
+
 bool qdGameDispatcher::mouse_handler(int x, int y, mouseDispatcher::mouseEvent ev) {
 	debugC(9, kDebugInput, "qdGameDispatcher::mouse_handler(%d, %d, %d)", x, y, ev);
 	if ((ev == mouseDispatcher::EV_LEFT_DOWN || ev == mouseDispatcher::EV_RIGHT_DOWN) && _mouse_obj->object()) {
@@ -1015,6 +1135,8 @@ bool qdGameDispatcher::init_triggers() {
 #endif
 	}
 
+	compile_conditions();
+
 	return result;
 }
 
@@ -1025,7 +1147,31 @@ bool qdGameDispatcher::reset_triggers() {
 	return true;
 }
 
+void qdGameDispatcher::compile_conditions() {
+	qdCondition::invalidate_bindings();
+	qdNamedObject::reset_change_epoch();
+
+	for (auto &it : trigger_chain_list()) {
+		for (auto &el : it->elements_list()) {
+			if (qdConditionalObject *p = dynamic_cast<qdConditionalObject *>(el->object()))
+				p->compile_conditions();
+		}
+	}
+
+	if (_cur_scene) {
+		for (auto &it : _cur_scene->object_list()) {
+			if (qdGameObjectAnimated *p = dynamic_cast<qdGameObjectAnimated *>(it)) {
+				for (auto &st : p->state_vector())
+					st->compile_conditions();
+			}
+		}
+	}
+}
+
 bool qdGameDispatcher::check_condition(qdCondition *cnd) {
+	if (!cnd->is_compiled())
+		cnd->compile();
+
 	switch (cnd->type()) {
 	case qdCondition::CONDITION_TRUE:
 		return true;
@@ -1041,18 +1187,8 @@ bool qdGameDispatcher::check_condition(qdCondition *cnd) {
 					return false;
 			}
 
-			const qdNamedObject *p = cnd->get_object(qdCondition::OBJECT_NAME);
-
-			if (!p) {
-				const char *object_name;
-				if (!cnd->get_value(qdCondition::OBJECT_NAME, object_name) || !strlen(object_name)) {
-					if (cnd->owner())
-						p = cnd->owner()->owner();
-				} else
-					p = get_object(object_name);
-
-				if (!p) return false;
-			}
+			const qdNamedObject *p = cnd->bound_object(qdCondition::OBJECT_NAME);
+			if (!p) return false;
 
 			qdGameScene *sc = get_active_scene();
 			if (!sc) return false;
@@ -1073,7 +1209,7 @@ bool qdGameDispatcher::check_condition(qdCondition *cnd) {
 					return false;
 			}
 
-			const qdNamedObject *p = cnd->get_object(qdCondition::OBJECT_NAME);
+			const qdNamedObject *p = cnd->bound_object(qdCondition::OBJECT_NAME);
 			if (!p) return false;
 
 			qdGameScene *sc = get_active_scene();
@@ -1095,33 +1231,15 @@ bool qdGameDispatcher::check_condition(qdCondition *cnd) {
 					return false;
 			}
 
-			const qdNamedObject *p = cnd->get_object(qdCondition::OBJECT_NAME);
-			if (!p) {
-				const char *object_name;
-				if (!cnd->get_value(qdCondition::OBJECT_NAME, object_name) || !strlen(object_name)) {
-					if (cnd->owner())
-						p = cnd->owner()->owner();
-				} else
-					p = get_object(object_name);
-
-				if (!p) return false;
-			}
+			const qdNamedObject *p = cnd->bound_object(qdCondition::OBJECT_NAME);
+			if (!p) return false;
 
 			qdGameScene *sc = get_active_scene();
 			if (!sc) return false;
 
 			if (p == sc->mouse_click_object()) {
-				const qdGameObject *m_obj = dynamic_cast<const qdGameObject *>(cnd->get_object(qdCondition::MOUSE_OBJECT_NAME));
-				if (!m_obj) {
-					const char *object_name;
-					if (!cnd->get_value(qdCondition::MOUSE_OBJECT_NAME, object_name) || !strlen(object_name))
-						return false;
-
-					m_obj = get_object(object_name);
-					if (!m_obj) return false;
-				}
-
-				if (m_obj == _mouse_click_obj)
+				const qdGameObject *m_obj = cnd->bound_game_object(qdCondition::MOUSE_OBJECT_NAME);
+				if (m_obj && m_obj == _mouse_click_obj)
 					return true;
 			}
 		}
@@ -1136,67 +1254,35 @@ bool qdGameDispatcher::check_condition(qdCondition *cnd) {
 					return false;
 			}
 
-			const qdNamedObject *p = cnd->get_object(qdCondition::OBJECT_NAME);
+			const qdNamedObject *p = cnd->bound_object(qdCondition::OBJECT_NAME);
 			if (!p) return false;
 
 			qdGameScene *sc = get_active_scene();
 			if (!sc) return false;
 
 			if (p == sc->mouse_right_click_object()) {
-				const qdGameObject *m_obj = dynamic_cast<const qdGameObject *>(cnd->get_object(qdCondition::MOUSE_OBJECT_NAME));
+				const qdGameObject *m_obj = cnd->bound_game_object(qdCondition::MOUSE_OBJECT_NAME);
 				if (m_obj == _mouse_click_obj)
 					return true;
 			}
 		}
 		return false;
 	case qdCondition::CONDITION_OBJECT_IN_ZONE: {
-		const qdGameObject *obj = dynamic_cast<const qdGameObject *>(cnd->get_object(qdCondition::OBJECT_NAME));
-		if (!obj) {
-			const char *object_name;
-			if (!cnd->get_value(qdCondition::OBJECT_NAME, object_name) || !strlen(object_name)) {
-				if (cnd->owner())
-					obj = dynamic_cast<const qdGameObject * >(cnd->owner()->owner());
-			} else
-				obj = get_object(object_name);
-
-			if (!obj) return false;
-		}
+		const qdGameObject *obj = cnd->bound_game_object(qdCondition::OBJECT_NAME);
+		if (!obj) return false;
 
 		if (!obj->is_visible())
 			return false;
 
-		const qdGridZone *zone = NULL;
-		if (const qdNamedObject * zone_obj = cnd->get_object(qdCondition::ZONE_NAME)) {
-			if (zone_obj->named_object_type() != QD_NAMED_OBJECT_GRID_ZONE)
-				return false;
-			zone = dynamic_cast<const qdGridZone *>(zone_obj);
-		} else {
-			qdGameScene *sc = get_active_scene();
-			if (!sc) return false;
-
-			const char *zone_name;
-			if (!cnd->get_value(qdCondition::ZONE_NAME, zone_name))
-				return false;
-
-			zone = sc->get_grid_zone(zone_name);
-		}
-
+		const qdGridZone *zone = cnd->bound_zone(qdCondition::ZONE_NAME);
 		if (!zone) return false;
+
 		return zone->is_object_in_zone(obj);
 	}
 	return false;
 	case qdCondition::CONDITION_PERSONAGE_WALK_DIRECTION: {
-		const qdGameObjectMoving *p = dynamic_cast<const qdGameObjectMoving *>(cnd->get_object(qdCondition::PERSONAGE_NAME));
-		if (!p) {
-			const char *object_name;
-			if (!cnd->get_value(qdCondition::PERSONAGE_NAME, object_name) || !strlen(object_name)) {
-				if (!cnd->owner() || !cnd->owner()->owner()) return false;
-				p = dynamic_cast<const qdGameObjectMoving *>(cnd->owner()->owner());
-			} else
-				p = dynamic_cast<const qdGameObjectMoving *>(get_object(object_name));
-
-			if (!p) return false;
-		}
+		const qdGameObjectMoving *p = cnd->bound_personage(qdCondition::PERSONAGE_NAME);
+		if (!p) return false;
 
 		if (!p->is_visible())
 			return false;
@@ -1213,17 +1299,8 @@ bool qdGameDispatcher::check_condition(qdCondition *cnd) {
 	}
 	return false;
 	case qdCondition::CONDITION_PERSONAGE_STATIC_DIRECTION: {
-		const qdGameObjectMoving *p = dynamic_cast<const qdGameObjectMoving *>(cnd->get_object(qdCondition::PERSONAGE_NAME));
-		if (!p) {
-			const char *object_name;
-			if (!cnd->get_value(qdCondition::PERSONAGE_NAME, object_name) || !strlen(object_name)) {
-				if (!cnd->owner() || !cnd->owner()->owner()) return false;
-				p = dynamic_cast<const qdGameObjectMoving *>(cnd->owner()->owner());
-			} else
-				p = dynamic_cast<const qdGameObjectMoving *>(get_object(object_name));
-
-			if (!p) return false;
-		}
+		const qdGameObjectMoving *p = cnd->bound_personage(qdCondition::PERSONAGE_NAME);
+		if (!p) return false;
 
 		if (!p->is_visible())
 			return false;
@@ -1239,12 +1316,8 @@ bool qdGameDispatcher::check_condition(qdCondition *cnd) {
 		return true;
 	}
 	return false;
-	case qdCondition::CONDITION_TIMER: {
-		int state;
-		if (!cnd->get_value(qdCondition::TIMER_RND, state, 1) || !state) return false;
-		return true;
-	}
-	return false;
+	case qdCondition::CONDITION_TIMER:
+		return cnd->timer_state();
 	case qdCondition::CONDITION_MOUSE_DIALOG_CLICK: {
 		if (!check_flag(DIALOG_CLICK_FLAG) || _mouse_click_obj) return false;
 		if (cnd->owner() && cnd->owner() == _mouse_click_state)
@@ -1253,24 +1326,12 @@ bool qdGameDispatcher::check_condition(qdCondition *cnd) {
 	return false;
 	case qdCondition::CONDITION_MINIGAME_STATE:
 		return false;
-	case qdCondition::CONDITION_OBJECT_STATE: {
-		const qdGameObject *obj = dynamic_cast<const qdGameObject *>(cnd->get_object(qdCondition::OBJECT_NAME));
-		if (!obj) {
-			const char *object_name;
-			if (!cnd->get_value(qdCondition::OBJECT_NAME, object_name) || !strlen(object_name)) {
-				if (cnd->owner())
-					obj = dynamic_cast<const qdGameObject * >(cnd->owner()->owner());
-			} else
-				obj = get_object(object_name);
-
-			if (!obj) return false;
-		}
-
-		if (const qdGameObjectAnimated * p = dynamic_cast<const qdGameObjectAnimated * >(obj)) {
+	case qdCondition::CONDITION_OBJECT_STATE:
+		if (const qdGameObjectAnimated * p = cnd->bound_animated_object(qdCondition::OBJECT_NAME)) {
 			if (!p->is_visible())
 				return false;
 
-			if (const qdGameObjectState * sp = dynamic_cast<const qdGameObjectState * >(cnd->get_object(qdCondition::OBJECT_STATE_NAME))) {
+			if (const qdGameObjectState * sp = cnd->bound_state(qdCondition::OBJECT_STATE_NAME)) {
 				return p->is_state_active(sp);
 			} else {
 				const char *state_name;
@@ -1280,8 +1341,7 @@ bool qdGameDispatcher::check_condition(qdCondition *cnd) {
 				return p->is_state_active(state_name);
 			}
 		}
-	}
-	return false;
+		return false;
 	case qdCondition::CONDITION_MOUSE_ZONE_CLICK:
 		if (mouseDispatcher::instance()->is_event_active(mouseDispatcher::EV_LEFT_DOWN)) {
 			if (check_flag(OBJECT_CLICK_FLAG | DIALOG_CLICK_FLAG) || _mouse_click_obj) return false;
@@ -1295,16 +1355,8 @@ bool qdGameDispatcher::check_condition(qdCondition *cnd) {
 					return false;
 			}
 
-			const qdGridZone *zone = dynamic_cast<const qdGridZone *>(cnd->get_object(qdCondition::CLICK_ZONE_NAME));
-
-			if (!zone) {
-				const char *zone_name;
-				if (!cnd->get_value(qdCondition::CLICK_ZONE_NAME, zone_name))
-					return false;
-
-				zone = sc->get_grid_zone(zone_name);
-				if (!zone) return false;
-			}
+			const qdGridZone *zone = cnd->bound_zone(qdCondition::CLICK_ZONE_NAME);
+			if (!zone) return false;
 
 			return zone->is_point_in_zone(sc->mouse_click_pos());
 		}
@@ -1322,48 +1374,19 @@ bool qdGameDispatcher::check_condition(qdCondition *cnd) {
 					return false;
 			}
 
-			const qdGridZone *zone = dynamic_cast<const qdGridZone *>(cnd->get_object(qdCondition::CLICK_ZONE_NAME));
-
-			if (!zone) {
-				const char *zone_name;
-				if (!cnd->get_value(qdCondition::CLICK_ZONE_NAME, zone_name))
-					return false;
-
-				zone = sc->get_grid_zone(zone_name);
-				if (!zone) return false;
-			}
+			const qdGridZone *zone = cnd->bound_zone(qdCondition::CLICK_ZONE_NAME);
+			if (!zone) return false;
 
 			if (zone->is_point_in_zone(sc->mouse_click_pos())) {
-				const qdGameObject *m_obj = dynamic_cast<const qdGameObject *>(cnd->get_object(qdCondition::MOUSE_OBJECT_NAME));
-				if (!m_obj) {
-					const char *object_name;
-					if (!cnd->get_value(qdCondition::MOUSE_OBJECT_NAME, object_name) || !strlen(object_name))
-						return false;
-
-					m_obj = get_object(object_name);
-					if (!m_obj) return false;
-				}
-
-				if (m_obj == _mouse_click_obj)
+				const qdGameObject *m_obj = cnd->bound_game_object(qdCondition::MOUSE_OBJECT_NAME);
+				if (m_obj && m_obj == _mouse_click_obj)
 					return true;
 			}
 		}
 		return false;
-	case qdCondition::CONDITION_OBJECT_STATE_WAS_ACTIVATED: {
-		const qdGameObject *obj = static_cast<const qdGameObject *>(cnd->get_object(qdCondition::OBJECT_NAME));
-		if (!obj) {
-			const char *object_name;
-			if (!cnd->get_value(qdCondition::OBJECT_NAME, object_name) || !strlen(object_name)) {
-				if (cnd->owner())
-					obj = static_cast<const qdGameObject * >(cnd->owner()->owner());
-			} else
-				obj = get_object(object_name);
-
-			if (!obj) return false;
-		}
-
-		if (const qdGameObjectAnimated * p = dynamic_cast<const qdGameObjectAnimated * >(obj)) {
-			if (const qdGameObjectState * sp = static_cast<const qdGameObjectState * >(cnd->get_object(qdCondition::OBJECT_STATE_NAME))) {
+	case qdCondition::CONDITION_OBJECT_STATE_WAS_ACTIVATED:
+		if (const qdGameObjectAnimated * p = cnd->bound_animated_object(qdCondition::OBJECT_NAME)) {
+			if (const qdGameObjectState * sp = cnd->bound_state(qdCondition::OBJECT_STATE_NAME)) {
 				return p->was_state_active(sp);
 			} else {
 				const char *state_name;
@@ -1373,29 +1396,14 @@ bool qdGameDispatcher::check_condition(qdCondition *cnd) {
 				return p->was_state_active(state_name);
 			}
 		}
-	}
-	return false;
+		return false;
 	case qdCondition::CONDITION_OBJECTS_DISTANCE: {
-		const char *object_name;
-
-		const qdGameObject *obj1 = dynamic_cast<const qdGameObject *>(cnd->get_object(qdCondition::OBJECT_NAME));
-		if (!obj1) {
-			if (cnd->get_value(qdCondition::OBJECT_NAME, object_name) && strlen(object_name))
-				obj1 = get_object(object_name);
-			if (!obj1) return false;
-		}
-
-		if (!obj1->is_visible())
+		const qdGameObject *obj1 = cnd->bound_game_object(qdCondition::OBJECT_NAME);
+		if (!obj1 || !obj1->is_visible())
 			return false;
 
-		const qdGameObject *obj2 = dynamic_cast<const qdGameObject *>(cnd->get_object(qdCondition::OBJECT2_NAME));
-		if (!obj2) {
-			if (cnd->get_value(qdCondition::OBJECT2_NAME, object_name) && strlen(object_name))
-				obj2 = get_object(object_name);
-			if (!obj2) return false;
-		}
-
-		if (!obj2->is_visible())
+		const qdGameObject *obj2 = cnd->bound_game_object(qdCondition::OBJECT2_NAME);
+		if (!obj2 || !obj2->is_visible())
 			return false;
 
 		float dist = 0.0f;
@@ -1409,39 +1417,16 @@ bool qdGameDispatcher::check_condition(qdCondition *cnd) {
 	return false;
 	case qdCondition::CONDITION_PERSONAGE_ACTIVE:
 		if (get_active_personage()) {
-			const qdGameObjectMoving *p = dynamic_cast<const qdGameObjectMoving *>(cnd->get_object(qdCondition::PERSONAGE_NAME));
-			if (!p) {
-				const char *object_name;
-				if (!cnd->get_value(qdCondition::PERSONAGE_NAME, object_name) || !strlen(object_name)) {
-					if (!cnd->owner() || !cnd->owner()->owner()) return false;
-					p = dynamic_cast<const qdGameObjectMoving *>(cnd->owner()->owner());
-				} else
-					p = dynamic_cast<const qdGameObjectMoving *>(get_object(object_name));
-
-				if (!p) return false;
-			}
-
-			if (p == get_active_personage()) return true;
+			const qdGameObjectMoving *p = cnd->bound_personage(qdCondition::PERSONAGE_NAME);
+			if (p && p == get_active_personage()) return true;
 		}
 		return false;
-	case qdCondition::CONDITION_OBJECT_STATE_WAITING: {
-		const qdGameObject *obj = dynamic_cast<const qdGameObject *>(cnd->get_object(qdCondition::OBJECT_NAME));
-		if (!obj) {
-			const char *object_name;
-			if (!cnd->get_value(qdCondition::OBJECT_NAME, object_name) || !strlen(object_name)) {
-				if (cnd->owner())
-					obj = dynamic_cast<const qdGameObject * >(cnd->owner()->owner());
-			} else
-				obj = get_object(object_name);
-
-			if (!obj) return false;
-		}
-
-		if (const qdGameObjectAnimated * p = dynamic_cast<const qdGameObjectAnimated * >(obj)) {
+	case qdCondition::CONDITION_OBJECT_STATE_WAITING:
+		if (const qdGameObjectAnimated * p = cnd->bound_animated_object(qdCondition::OBJECT_NAME)) {
 			if (!p->is_visible())
 				return false;
 
-			if (const qdGameObjectState * sp = dynamic_cast<const qdGameObjectState * >(cnd->get_object(qdCondition::OBJECT_STATE_NAME))) {
+			if (const qdGameObjectState * sp = cnd->bound_state(qdCondition::OBJECT_STATE_NAME)) {
 				return p->is_state_waiting(sp);
 			} else {
 				const char *state_name;
@@ -1451,26 +1436,13 @@ bool qdGameDispatcher::check_condition(qdCondition *cnd) {
 				return p->is_state_waiting(state_name);
 			}
 		}
-	}
-	return false;
-	case qdCondition::CONDITION_OBJECT_STATE_ANIMATION_PHASE: {
-		const qdGameObject *obj = dynamic_cast<const qdGameObject *>(cnd->get_object(qdCondition::OBJECT_NAME));
-		if (!obj) {
-			const char *object_name;
-			if (!cnd->get_value(qdCondition::OBJECT_NAME, object_name) || !strlen(object_name)) {
-				if (cnd->owner())
-					obj = dynamic_cast<const qdGameObject * >(cnd->owner()->owner());
-			} else
-				obj = get_object(object_name);
-
-			if (!obj) return false;
-		}
-
-		if (const qdGameObjectAnimated * p = dynamic_cast<const qdGameObjectAnimated * >(obj)) {
+		return false;
+	case qdCondition::CONDITION_OBJECT_STATE_ANIMATION_PHASE:
+		if (const qdGameObjectAnimated * p = cnd->bound_animated_object(qdCondition::OBJECT_NAME)) {
 			if (!p->is_visible())
 				return false;
 
-			const qdGameObjectState *sp = dynamic_cast<const qdGameObjectState *>(cnd->get_object(qdCondition::OBJECT_STATE_NAME));
+			const qdGameObjectState *sp = cnd->bound_state(qdCondition::OBJECT_STATE_NAME);
 			if (!sp) {
 				const char *state_name;
 				if (!cnd->get_value(qdCondition::OBJECT_STATE_NAME, state_name) || !strlen(state_name))
@@ -1491,26 +1463,13 @@ bool qdGameDispatcher::check_condition(qdCondition *cnd) {
 			if (phase >= phase0 && phase <= phase1)
 				return true;
 		}
-	}
-	return false;
-	case qdCondition::CONDITION_OBJECT_PREV_STATE: {
-		const qdGameObject *obj = dynamic_cast<const qdGameObject *>(cnd->get_object(qdCondition::OBJECT_NAME));
-		if (!obj) {
-			const char *object_name;
-			if (!cnd->get_value(qdCondition::OBJECT_NAME, object_name) || !strlen(object_name)) {
-				if (cnd->owner())
-					obj = dynamic_cast<const qdGameObject * >(cnd->owner()->owner());
-			} else
-				obj = get_object(object_name);
-
-			if (!obj) return false;
-		}
-
-		if (const qdGameObjectAnimated * p = dynamic_cast<const qdGameObjectAnimated * >(obj)) {
+		return false;
+	case qdCondition::CONDITION_OBJECT_PREV_STATE:
+		if (const qdGameObjectAnimated * p = cnd->bound_animated_object(qdCondition::OBJECT_NAME)) {
 			if (!p->is_visible())
 				return false;
 
-			if (const qdGameObjectState * sp = dynamic_cast<const qdGameObjectState * >(cnd->get_object(qdCondition::OBJECT_STATE_NAME))) {
+			if (const qdGameObjectState * sp = cnd->bound_state(qdCondition::OBJECT_STATE_NAME)) {
 				return p->was_state_previous(sp);
 			} else {
 				const char *state_name;
@@ -1520,13 +1479,9 @@ bool qdGameDispatcher::check_condition(qdCondition *cnd) {
 				return p->was_state_previous(state_name);
 			}
 		}
-	}
-	return false;
+		return false;
 	case qdCondition::CONDITION_STATE_TIME_GREATER_THAN_VALUE:
-		if (const qdNamedObject * p = cnd->get_object(0)) {
-			if (p->named_object_type() != QD_NAMED_OBJECT_OBJ_STATE) return false;
-			const qdGameObjectState *sp = static_cast<const qdGameObjectState *>(p);
-
+		if (const qdGameObjectState * sp = cnd->bound_state(0)) {
 			if (!sp->is_active()) return false;
 
 			float time;
@@ -1537,26 +1492,17 @@ bool qdGameDispatcher::check_condition(qdCondition *cnd) {
 		}
 		return false;
 	case qdCondition::CONDITION_STATE_TIME_GREATER_THAN_STATE_TIME:
-		if (const qdNamedObject * p = cnd->get_object(0)) {
-			if (p->named_object_type() != QD_NAMED_OBJECT_OBJ_STATE) return false;
-			const qdGameObjectState *sp0 = static_cast<const qdGameObjectState *>(p);
-
+		if (const qdGameObjectState * sp0 = cnd->bound_state(0)) {
 			if (!sp0->is_active()) return false;
 
-			p = cnd->get_object(1);
-			if (p->named_object_type() != QD_NAMED_OBJECT_OBJ_STATE) return false;
-			const qdGameObjectState *sp1 = static_cast<const qdGameObjectState *>(p);
-
-			if (!sp1->is_active()) return false;
+			const qdGameObjectState *sp1 = cnd->bound_state(1);
+			if (!sp1 || !sp1->is_active()) return false;
 
 			return (sp0->cur_time() > sp1->cur_time());
 		}
 		return false;
 	case qdCondition::CONDITION_STATE_TIME_IN_INTERVAL:
-		if (const qdNamedObject * p = cnd->get_object(0)) {
-			if (p->named_object_type() != QD_NAMED_OBJECT_OBJ_STATE) return false;
-			const qdGameObjectState *sp = static_cast<const qdGameObjectState *>(p);
-
+		if (const qdGameObjectState * sp = cnd->bound_state(0)) {
 			if (!sp->is_active()) return false;
 
 			float time0, time1;
@@ -1570,10 +1516,7 @@ bool qdGameDispatcher::check_condition(qdCondition *cnd) {
 		}
 		return false;
 	case qdCondition::CONDITION_COUNTER_GREATER_THAN_VALUE:
-		if (const qdNamedObject * p = cnd->get_object(0)) {
-			if (p->named_object_type() != QD_NAMED_OBJECT_COUNTER) return false;
-			const qdCounter *cp = static_cast<const qdCounter *>(p);
-
+		if (const qdCounter * cp = cnd->bound_counter(0)) {
 			int value;
 			if (!cnd->get_value(0, value))
 				return false;
@@ -1582,10 +1525,7 @@ bool qdGameDispatcher::check_condition(qdCondition *cnd) {
 		}
 		return false;
 	case qdCondition::CONDITION_COUNTER_LESS_THAN_VALUE:
-		if (const qdNamedObject * p = cnd->get_object(0)) {
-			if (p->named_object_type() != QD_NAMED_OBJECT_COUNTER) return false;
-			const qdCounter *cp = static_cast<const qdCounter *>(p);
-
+		if (const qdCounter * cp = cnd->bound_counter(0)) {
 			int value;
 			if (!cnd->get_value(0, value))
 				return false;
@@ -1594,22 +1534,15 @@ bool qdGameDispatcher::check_condition(qdCondition *cnd) {
 		}
 		return false;
 	case qdCondition::CONDITION_COUNTER_GREATER_THAN_COUNTER:
-		if (const qdNamedObject * p = cnd->get_object(0)) {
-			if (p->named_object_type() != QD_NAMED_OBJECT_COUNTER) return false;
-			const qdCounter *cp0 = static_cast<const qdCounter *>(p);
-
-			p = cnd->get_object(1);
-			if (p->named_object_type() != QD_NAMED_OBJECT_COUNTER) return false;
-			const qdCounter *cp1 = static_cast<const qdCounter *>(p);
+		if (const qdCounter * cp0 = cnd->bound_counter(0)) {
+			const qdCounter *cp1 = cnd->bound_counter(1);
+			if (!cp1) return false;
 
 			return (cp0->value() > cp1->value());
 		}
 		return false;
 	case qdCondition::CONDITION_COUNTER_IN_INTERVAL:
-		if (const qdNamedObject * p = cnd->get_object(0)) {
-			if (p->named_object_type() != QD_NAMED_OBJECT_COUNTER) return false;
-			const qdCounter *cp = static_cast<const qdCounter *>(p);
-
+		if (const qdCounter * cp = cnd->bound_counter(0)) {
 			int value0, value1;
 			if (!cnd->get_value(0, value0, 0))
 				return false;
@@ -1620,14 +1553,10 @@ bool qdGameDispatcher::check_condition(qdCondition *cnd) {
 		}
 		return false;
 	case qdCondition::CONDITION_OBJECT_ON_PERSONAGE_WAY:
-		if (const qdNamedObject * p = cnd->get_object(0)) {
-			if (p->named_object_type() != QD_NAMED_OBJECT_MOVING_OBJ) return false;
-			const qdGameObjectMoving *obj = static_cast<const qdGameObjectMoving *>(p);
+		if (const qdGameObjectMoving * obj = cnd->bound_personage(0)) {
 			if (!obj->is_visible()) return false;
 
-			p = cnd->get_object(1);
-			if (!p) return false;
-			const qdGameObject *obj1 = dynamic_cast<const qdGameObject *>(p);
+			const qdGameObject *obj1 = cnd->bound_game_object(1);
 			if (!obj1 || !obj1->is_visible()) return false;
 
 			float dist = 0.0f;
@@ -1650,13 +1579,11 @@ bool qdGameDispatcher::check_condition(qdCondition *cnd) {
 	}
 	return false;
 	case qdCondition::CONDITION_ANY_PERSONAGE_IN_ZONE:
-		if (const qdNamedObject * p = cnd->get_object(0)) {
-			if (p->named_object_type() != QD_NAMED_OBJECT_GRID_ZONE) return false;
-			return static_cast<const qdGridZone *>(p)->is_any_personage_in_zone();
-		}
+		if (const qdGridZone * zone = cnd->bound_zone(0))
+			return zone->is_any_personage_in_zone();
 		return false;
 	case qdCondition::CONDITION_OBJECT_HIDDEN: {
-		const qdGameObject *obj = dynamic_cast<const qdGameObject *>(cnd->get_object(qdCondition::OBJECT_NAME));
+		const qdGameObject *obj = cnd->bound_game_object(qdCondition::OBJECT_NAME);
 		if (!obj) return false;
 		return !obj->is_visible();
 	}
@@ -1674,7 +1601,7 @@ bool qdGameDispatcher::check_condition(qdCondition *cnd) {
 					return false;
 			}
 
-			const qdGridZone *zone = dynamic_cast<const qdGridZone *>(cnd->get_object(qdCondition::CLICK_ZONE_NAME));
+			const qdGridZone *zone = cnd->bound_zone(qdCondition::CLICK_ZONE_NAME);
 			if (!zone) return false;
 
 			return zone->is_point_in_zone(sc->mouse_click_pos());
@@ -1693,11 +1620,11 @@ bool qdGameDispatcher::check_condition(qdCondition *cnd) {
 					return false;
 			}
 
-			const qdGridZone *zone = dynamic_cast<const qdGridZone *>(cnd->get_object(qdCondition::CLICK_ZONE_NAME));
+			const qdGridZone *zone = cnd->bound_zone(qdCondition::CLICK_ZONE_NAME);
 			if (!zone) return false;
 
 			if (zone->is_point_in_zone(sc->mouse_click_pos())) {
-				const qdGameObject *m_obj = dynamic_cast<const qdGameObject *>(cnd->get_object(qdCondition::MOUSE_OBJECT_NAME));
+				const qdGameObject *m_obj = cnd->bound_game_object(qdCondition::MOUSE_OBJECT_NAME);
 				if (m_obj && m_obj == _mouse_click_obj)
 					return true;
 			}
@@ -1705,14 +1632,8 @@ bool qdGameDispatcher::check_condition(qdCondition *cnd) {
 		return false;
 	case qdCondition::CONDITION_MOUSE_HOVER:
 		if (!mouseDispatcher::instance()->is_event_active(mouseDispatcher::EV_LEFT_DOWN) && !mouseDispatcher::instance()->is_event_active(mouseDispatcher::EV_RIGHT_DOWN)) {
-			const qdNamedObject *p = cnd->get_object(qdCondition::OBJECT_NAME);
-
-			if (!p) {
-				if (cnd->owner())
-					p = cnd->owner()->owner();
-
-				if (!p) return false;
-			}
+			const qdNamedObject *p = cnd->bound_object(qdCondition::OBJECT_NAME);
+			if (!p) return false;
 
 			qdGameScene *sc = get_active_scene();
 			if (!sc) return false;
@@ -1725,21 +1646,15 @@ bool qdGameDispatcher::check_condition(qdCondition *cnd) {
 		return false;
 	case qdCondition::CONDITION_MOUSE_OBJECT_HOVER:
 		if (!mouseDispatcher::instance()->is_event_active(mouseDispatcher::EV_LEFT_DOWN) && !mouseDispatcher::instance()->is_event_active(mouseDispatcher::EV_RIGHT_DOWN)) {
-			const qdNamedObject *p = cnd->get_object(qdCondition::OBJECT_NAME);
-
-			if (!p) {
-				if (cnd->owner())
-					p = cnd->owner()->owner();
-
-				if (!p) return false;
-			}
+			const qdNamedObject *p = cnd->bound_object(qdCondition::OBJECT_NAME);
+			if (!p) return false;
 
 			qdGameScene *sc = get_active_scene();
 			if (!sc) return false;
 
 			if (sc->mouse_hover_object()) {
 				if (p == sc->mouse_hover_object()) {
-					const qdGameObject *m_obj = dynamic_cast<const qdGameObject *>(cnd->get_object(qdCondition::MOUSE_OBJECT_NAME));
+					const qdGameObject *m_obj = cnd->bound_game_object(qdCondition::MOUSE_OBJECT_NAME);
 					if (m_obj && m_obj == _mouse_obj->object())
 						return true;
 				}
@@ -1753,7 +1668,7 @@ bool qdGameDispatcher::check_condition(qdCondition *cnd) {
 			qdGameScene *sc = get_active_scene();
 			if (!sc || sc->mouse_click_object()) return false;
 
-			const qdGridZone *zone = dynamic_cast<const qdGridZone *>(cnd->get_object(qdCondition::CLICK_ZONE_NAME));
+			const qdGridZone *zone = cnd->bound_zone(qdCondition::CLICK_ZONE_NAME);
 			if (!zone) return false;
 
 			return zone->is_point_in_zone(sc->mouse_click_pos());
@@ -1772,11 +1687,11 @@ bool qdGameDispatcher::check_condition(qdCondition *cnd) {
 					return false;
 			}
 
-			const qdGridZone *zone = dynamic_cast<const qdGridZone *>(cnd->get_object(qdCondition::CLICK_ZONE_NAME));
+			const qdGridZone *zone = cnd->bound_zone(qdCondition::CLICK_ZONE_NAME);
 			if (!zone) return false;
 
 			if (zone->is_point_in_zone(sc->mouse_click_pos())) {
-				const qdGameObject *m_obj = dynamic_cast<const qdGameObject *>(cnd->get_object(qdCondition::MOUSE_OBJECT_NAME));
+				const qdGameObject *m_obj = cnd->bound_game_object(qdCondition::MOUSE_OBJECT_NAME);
 				if (m_obj && m_obj == _mouse_obj->object())
 					return true;
 			}
@@ -1803,7 +1718,7 @@ bool qdGameDispatcher::check_condition(qdCondition *cnd) {
 		if (mouseDispatcher::instance()->is_event_active(mouseDispatcher::EV_LEFT_DOWN)) {
 			if (!check_flag(OBJECT_CLICK_FLAG) || check_flag(DIALOG_CLICK_FLAG) || !_mouse_click_obj) return false;
 
-			const qdGameObject *m_obj = dynamic_cast<const qdGameObject *>(cnd->get_object(0));
+			const qdGameObject *m_obj = cnd->bound_game_object(0);
 			return (!m_obj || m_obj == _mouse_click_obj);
 
 			return true;
@@ -1819,7 +1734,7 @@ bool qdGameDispatcher::check_condition(qdCondition *cnd) {
 		if (mouseDispatcher::instance()->is_event_active(mouseDispatcher::EV_RIGHT_DOWN)) {
 			if (!check_flag(OBJECT_CLICK_FLAG) || check_flag(DIALOG_CLICK_FLAG) || !_mouse_click_obj) return false;
 
-			const qdGameObject *m_obj = dynamic_cast<const qdGameObject *>(cnd->get_object(0));
+			const qdGameObject *m_obj = cnd->bound_game_object(0);
 			return (!m_obj || m_obj == _mouse_click_obj);
 
 			return true;
@@ -1828,7 +1743,7 @@ bool qdGameDispatcher::check_condition(qdCondition *cnd) {
 	case qdCondition::CONDITION_MOUSE_STATE_PHRASE_CLICK:
 		if (mouseDispatcher::instance()->is_event_active(mouseDispatcher::EV_LEFT_DOWN)) {
 			if (check_flag(DIALOG_CLICK_FLAG) && !_mouse_click_obj) {
-				const qdGameObjectState *p = dynamic_cast<const qdGameObjectState *>(cnd->get_object(0));
+				const qdGameObjectState *p = cnd->bound_state(0);
 				if (!p) return false;
 
 				return (p == _mouse_click_state);
@@ -1836,17 +1751,13 @@ bool qdGameDispatcher::check_condition(qdCondition *cnd) {
 		}
 		return false;
 	case qdCondition::CONDITION_OBJECT_IS_CLOSER: {
-		const qdGameObject *obj0 = dynamic_cast<const qdGameObject *>(cnd->get_object(0));
-		if (!obj0) {
-			if (cnd->owner())
-				obj0 = dynamic_cast<const qdGameObject * >(cnd->owner()->owner());
-		}
+		const qdGameObject *obj0 = cnd->bound_game_object(0);
 		if (!obj0) return false;
 
-		const qdGameObject *obj1 = dynamic_cast<const qdGameObject *>(cnd->get_object(1));
+		const qdGameObject *obj1 = cnd->bound_game_object(1);
 		if (!obj1) return false;
 
-		const qdGameObject *obj2 = dynamic_cast<const qdGameObject *>(cnd->get_object(2));
+		const qdGameObject *obj2 = cnd->bound_game_object(2);
 		if (!obj2) return false;
 
 		Vect3f dr1 = obj1->R() - obj0->R();
@@ -1858,8 +1769,7 @@ bool qdGameDispatcher::check_condition(qdCondition *cnd) {
 	}
 	return false;
 	case qdCondition::CONDITION_ANIMATED_OBJECT_IDLE_GREATER_THAN_VALUE: {
-		const qdGameObjectAnimated *anim_obj =
-		    dynamic_cast<const qdGameObjectAnimated *>(cnd->get_object(0));
+		const qdGameObjectAnimated *anim_obj = cnd->bound_animated_object(0);
 
 		if (NULL == anim_obj) return false;
 
@@ -1871,10 +1781,8 @@ bool qdGameDispatcher::check_condition(qdCondition *cnd) {
 	}
 	return false;
 	case qdCondition::CONDITION_ANIMATED_OBJECTS_INTERSECTIONAL_BOUNDS: {
-		const qdGameObjectAnimated *anim1 =
-		    dynamic_cast<const qdGameObjectAnimated *>(cnd->get_object(0));
-		const qdGameObjectAnimated *anim2 =
-		    dynamic_cast<const qdGameObjectAnimated *>(cnd->get_object(1));
+		const qdGameObjectAnimated *anim1 = cnd->bound_animated_object(0);
+		const qdGameObjectAnimated *anim2 = cnd->bound_animated_object(1);
 
 		if ((NULL == anim1) || (NULL == anim2))
 			return false;
@@ -2168,6 +2076,7 @@ bool qdGameDispatcher::select_scene(qdGameScene *sp, bool resources_flag) {
 	int tm = g_system->getMillis();
 
 	toggle_full_redraw();
+	_fade_frame_ready = false;
 
 	_screen_texts.clear_texts();
 
@@ -2214,6 +2123,8 @@ bool qdGameDispatcher::select_scene(qdGameScene *sp, bool resources_flag) {
 		_interface_dispatcher.update_personage_buttons();
 	}
 
+	compile_conditions();
+
 	if (resources_flag) {
 		if (_mouse_obj->max_state()) {
 			_mouse_obj->free_resources();
@@ -2529,6 +2440,9 @@ bool qdGameDispatcher::load_save(Common::SeekableReadStream *fh) {
 
 	debugC(2, kDebugSave, "qdGameDispatcher::load_save(): TOTAL SIZE %ld", fh->pos());
 
+	// запомненные результаты условий после загрузки недействительны
+	qdNamedObject::reset_change_epoch();
+
 	if (cur_scene_ptr)
 		select_scene(cur_scene_ptr, false);
 
@@ -2765,6 +2679,12 @@ bool qdGameDispatcher::end_game(const qdGameEnd *p) {
 }
 
 bool qdGameDispatcher::add_redraw_region(const grScreenRegion &reg) {
+	if (_scroll_ghost_regions && !reg.is_empty()) {
+		grScreenRegion ghost = reg;
+		ghost.move(_scroll_delta.x, _scroll_delta.y);
+		grDispatcher::instance()->invalidate_region(ghost);
+	}
+
 	return grDispatcher::instance()->invalidate_region(reg);
 }
 
@@ -2801,7 +2721,7 @@ bool qdGameDispatcher::init() {
 		(*it)->init();
 
 	//! Грузим шрифты, заданные в qdGameDispatcher::qdFontInfoList
-	for (Std::list<qdFontInfo * >::const_iterator it = _fonts.get_list().begin();
+	for (qdFontInfoList::const_iterator it = _fonts.get_list().begin();
 	        it != _fonts.get_list().end(); ++it)
 		(*it)->load_font();
 
@@ -3161,6 +3081,8 @@ bool qdGameDispatcher::set_fade(bool fade_in, float duration) {
 	_fade_timer = 0.f;
 	_fade_duration = duration;
 
+	_fade_frame_ready = false;
+
 	return true;
 }
 
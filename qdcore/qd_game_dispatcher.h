@@ -37,6 +37,10 @@
 #include "qdengine/qdcore/qd_file_owner.h"
 #include "qdengine/qdcore/util/WinVideo.h"
 
+namespace Graphics {
+class ManagedSurface;
+}
+
 namespace QDEngine {
 
 class grFont;
@@ -398,6 +402,12 @@ public:
 	qdScaleInfo *get_scale_info(const char *p);
 
 	bool check_condition(qdCondition *cnd);
+	//! Компиляция условий триггеров и состояний объектов активной сцены.
+	/**
+	Вызывается при инициализации триггеров и смене сцены, так как объекты
+	условий ищутся по именам в активной сцене.
+	*/
+	void compile_conditions();
 
 	void pause();
 	void resume();
@@ -452,6 +462,14 @@ public:
 		return check_flag(FULLSCREEN_REDRAW_FLAG);
 	}
 
+	//! Прокрутка камеры на delta пикселов экрана.
+	/**
+	При следующей отрисовке изображение сдвигается целиком и перерисовываются
+	только открывшиеся полосы и изменившиеся объекты.
+	Для больших сдвигов и зацикленных сцен включается полная перерисовка.
+	*/
+	void scroll_screen(const Vect2i &delta);
+
 	static void set_dispatcher(qdGameDispatcher *p);
 	static qdGameDispatcher *get_dispatcher() {
 		return _dispatcher;
@@ -626,6 +644,15 @@ private:
 
 	qdScreenTextDispatcher _screen_texts;
 
+	//! Сдвиг изображения, накопленный с последней отрисовки, см. scroll_screen().
+	Vect2i _scroll_delta;
+	//! Добавлять к областям перерисовки их копии, сдвинутые на _scroll_delta.
+	bool _scroll_ghost_regions;
+	//! Изображение сдвигалось, на экран выводится целиком.
+	bool _scroll_flush;
+
+	void apply_scroll();
+
 	Common::String _startup_scene;
 
 	//! Файл с субтитрами.
@@ -648,6 +675,13 @@ private:
 	float _fade_timer;
 	float _fade_duration;
 
+	//! Кадр, который затемняется при смене сцены, см. qdGameConfig::fade_cached_frame().
+	Graphics::ManagedSurface *_fade_frame;
+	//! В _fade_frame запомнен весь экран, сцена под затемнением не перерисовывается.
+	bool _fade_frame_ready;
+	//! В текущей отрисовке в _fade_frame копировалось изображение.
+	bool _fade_frame_grabbed;
+
 	qdCameraMode _default_camera_mode;
 
 	static qdGameDispatcher *_dispatcher;
@@ -665,6 +699,8 @@ private:
 
 	void redraw(const grScreenRegion &reg);
 	void redraw_scene(bool draw_interface = true);
+	/// отрисовка сцены, интерфейса, инвентаря и текстов без затемнения
+	void redraw_scene_layers(bool draw_interface);
 
 	/// включает нужный экран внутриигрового интерфейса
 	bool update_ingame_interface();
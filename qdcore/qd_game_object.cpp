@@ -28,6 +28,7 @@
 #include "qdengine/parser/qdscr_parser.h"
 #include "qdengine/qdcore/qd_game_object.h"
 #include "qdengine/qdcore/qd_camera.h"
+#include "qdengine/qdcore/qd_game_scene.h"
 
 
 namespace QDEngine {
@@ -117,6 +118,8 @@ void qdGameObject::quant(float dt) {
 }
 
 bool qdGameObject::update_screen_pos() {
+	qdGameScene::invalidate_pick_grid();
+
 	if (!check_flag(QD_OBJ_SCREEN_COORDS_FLAG)) {
 		if (const qdCamera * cp = qdCamera::current_camera()) {
 			Vect3f v = cp->global2camera_coord(R());
@@ -82,6 +82,8 @@ public:
 	virtual grScreenRegion screen_region() const {
 		return grScreenRegion(grScreenRegion::EMPTY);
 	}
+	//! Сдвигает запомненную область экрана вслед за изображением при прокрутке.
+	virtual void move_last_screen_region(int dx, int dy) { }
 
 	virtual bool mouse_handler(int x, int y, mouseDispatcher::mouseEvent ev) = 0;
 	virtual bool hit(int x, int y) const = 0;
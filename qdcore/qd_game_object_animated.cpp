@@ -36,6 +36,8 @@
 
 namespace QDEngine {
 
+uint32 qdGameObjectAnimated::_shared_state_epoch = 0;
+
 qdGameObjectAnimated::qdGameObjectAnimated() : _cur_state(-1),
 	_inventory_type(0),
 	_last_state(NULL),
@@ -56,6 +58,9 @@ qdGameObjectAnimated::qdGameObjectAnimated() : _cur_state(-1),
 	_lastShadowColor = 0;
 	_lastShadowAlpha = QD_NO_SHADOW_ALPHA;
 
+	_state_index_valid = false;
+	_state_index_epoch = 0;
+
 	if (NULL != qdGameDispatcher::get_dispatcher())
 		_last_chg_time = qdGameDispatcher::get_dispatcher()->get_time();
 	else
@@ -83,6 +88,9 @@ qdGameObjectAnimated::qdGameObjectAnimated(const qdGameObjectAnimated &obj) : qd
 	_lastShadowColor = 0;
 	_lastShadowAlpha = QD_NO_SHADOW_ALPHA;
 
+	_state_index_valid = false;
+	_state_index_epoch = 0;
+
 	for (auto &it : obj._states) {
 		if (!it->check_flag(qdGameObjectState::QD_OBJ_STATE_FLAG_GLOBAL_OWNER))
 			add_state(it->clone());
@@ -133,6 +141,7 @@ qdGameObjectAnimated &qdGameObjectAnimated::operator = (const qdGameObjectAnimat
 	_last_chg_time = obj.last_chg_time();
 
 	clear_states();
+	drop_state_index();
 
 	for (auto &it : obj._states) {
 		if (!(it->check_flag(qdGameObjectState::QD_OBJ_STATE_FLAG_GLOBAL_OWNER))) {
@@ -381,6 +390,8 @@ bool qdGameObjectAnimated::insert_state(int iBefore, qdGameObjectState *p) {
 	p->inc_reference_count();
 
 	_states.insert(_states.begin() + iBefore, p);
+	drop_state_index();
+	touch();
 
 	if (!p->name()) {
 		Common::String nameStr;
@@ -395,6 +406,8 @@ bool qdGameObjectAnimated::add_state(qdGameObjectState *p) {
 	p->inc_reference_count();
 
 	_states.push_back(p);
+	drop_state_index();
+	touch();
 
 	if (!p->name()) {
 		Common::String nameStr;
@@ -412,6 +425,8 @@ qdGameObjectState *qdGameObjectAnimated::remove_state(int state_num) {
 
 	qdGameObjectState *p = *it;
 	_states.erase(it);
+	drop_state_index();
+	touch();
 
 	p->dec_reference_count();
 
@@ -425,6 +440,8 @@ bool qdGameObjectAnimated::remove_state(qdGameObjectState *p) {
 	qdGameObjectStateVector::iterator it = Common::find(_states.begin(), _states.end(), p);
 	if (it != _states.end()) {
 		_states.erase(it);
+		drop_state_index();
+		touch();
 		p->dec_reference_count();
 
 		if (_cur_state >= max_state())
@@ -536,6 +553,7 @@ void qdGameObjectAnimated::free_resources() {
 
 void qdGameObjectAnimated::set_state(int st) {
 	debugC(3, kDebugGraphics, "qdGameObjectAnimated::set_state(%d)", st);
+	qdGameScene::invalidate_pick_grid();
 	// Указание на смену состояния => объект меняется (устанавливаем время изм.)
 	_last_chg_time = qdGameDispatcher::get_dispatcher()->get_time();
 
@@ -855,25 +873,54 @@ bool qdGameObjectAnimated::hit(int x, int y) const {
 }
 
 qdGameObjectState *qdGameObjectAnimated::get_state(const char *state_name) {
-	for (auto &it : _states) {
-		if (it-> name() && !strcmp(it->name(), state_name)) {
-			return it;
-		}
-	}
+	int idx = get_state_index(state_name);
+	if (idx != -1)
+		return _states[idx];
 
 	return NULL;
 }
 
 const qdGameObjectState *qdGameObjectAnimated::get_state(const char *state_name) const {
-	for (auto &it : _states) {
-		const qdGameObjectState *p = it;
-		if (it->name() && !strcmp(it->name(), state_name))
-			return p;
-	}
+	int idx = get_state_index(state_name);
+	if (idx != -1)
+		return _states[idx];
 
 	return NULL;
 }
 
+int qdGameObjectAnimated::get_state_index(const char *state_name) const {
+	qdNameAtom atom = qdNameAtomTable::instance().find(state_name);
+	if (!atom) return -1;
+
+	if (!_state_index_valid || _state_index_epoch != _shared_state_epoch)
+		build_state_index();
+
+	state_index_t::const_iterator it = _state_index.find(atom);
+	if (it == _state_index.end())
+		return -1;
+
+	// имена в индексе совпадают без учета регистра, а сравниваются с учетом
+	for (int i = it->_value; i < _states.size(); i++) {
+		if (_states[i]->name_atom() == atom && !strcmp(_states[i]->name(), state_name))
+			return i;
+	}
+
+	return -1;
+}
+
+void qdGameObjectAnimated::build_state_index() const {
+	_state_index.clear();
+
+	for (int i = 0; i < _states.size(); i++) {
+		qdNameAtom atom = _states[i]->name_atom();
+		if (atom && !_state_index.contains(atom))
+			_state_index[atom] = i;
+	}
+
+	_state_index_valid = true;
+	_state_index_epoch = _shared_state_epoch;
+}
+
 qdGameObjectState *qdGameObjectAnimated::get_state(int state_index) {
 	if (state_index >= 0 && state_index < max_state())
 		return _states[state_index];
@@ -990,6 +1037,7 @@ void qdGameObjectAnimated::split_states(qdGameObjectAnimated *p) {
 	}
 
 	_cur_state = st;
+	touch();
 }
 
 bool qdGameObjectAnimated::init_grid_zone() {
@@ -1145,6 +1193,8 @@ bool qdGameObjectAnimated::auto_bound() {
 }
 
 bool qdGameObjectAnimated::handle_state_end() {
+	qdGameScene::invalidate_pick_grid();
+
 	qdGameObjectState *sp = _states[_cur_state];
 
 	if (sp->check_flag(qdGameObjectState::QD_OBJ_STATE_FLAG_RESTORE_PREV_STATE))
@@ -1283,6 +1333,8 @@ bool qdGameObjectAnimated::load_data(Common::SeekableReadStream &fh, int save_ve
 	_inventory_cell_index = fh.readSint32LE();
 	_last_chg_time = fh.readUint32LE();
 
+	touch();
+
 	debugC(4, kDebugSave, "    qdGameObjectAnimated::load_data after: %ld", fh.pos());
 
 	return true;
@@ -1346,10 +1398,8 @@ bool qdGameObjectAnimated::is_state_waiting(const char *state_name) const {
 }
 
 bool qdGameObjectAnimated::was_state_active(const char *state_name) const {
-	for (int i = 0; i < _states.size(); i++) {
-		if (!strcmp(_states[i]->name(), state_name))
-			return _states[i]->check_flag(qdGameObjectState::QD_OBJ_STATE_FLAG_WAS_ACTIVATED);
-	}
+	if (const qdGameObjectState *p = get_state(state_name))
+		return p->check_flag(qdGameObjectState::QD_OBJ_STATE_FLAG_WAS_ACTIVATED);
 
 	return false;
 }
@@ -1476,6 +1526,7 @@ bool qdGameObjectAnimated::init() {
 	for (int i = 0; i < _states.size(); i++)
 		_states[i]->init();
 
+	touch();
 	return true;
 }
 
@@ -22,6 +22,8 @@
 #ifndef QDENGINE_QDCORE_QD_GAME_OBJECT_ANIMATED_H
 #define QDENGINE_QDCORE_QD_GAME_OBJECT_ANIMATED_H
 
+#include "common/hashmap.h"
+
 #include "qdengine/parser/xml_fwd.h"
 #include "qdengine/qdcore/qd_animation.h"
 #include "qdengine/qdcore/qd_coords_animation.h"
@@ -80,7 +82,10 @@ public:
 	}
 	//! Устанавливает номер текущего состояния объекта.
 	void set_cur_state(int st) {
-		_cur_state = st;
+		if (_cur_state != st) {
+			_cur_state = st;
+			touch();
+		}
 	}
 	//! Возвращает количество состояний объекта.
 	int max_state() const {
@@ -88,6 +93,20 @@ public:
 	}
 	//! Возвращает номер состояния или -1 если не может такое состояние найти.
 	int get_state_index(const qdGameObjectState *p) const;
+	//! Возвращает номер состояния с именем state_name или -1 если не может такое состояние найти.
+	int get_state_index(const char *state_name) const;
+	//! Сбрасывает индекс состояний по именам, вызывается при переименовании состояния.
+	void drop_state_index() {
+		_state_index_valid = false;
+	}
+	//! Сбрасывает индексы состояний всех объектов, вызывается при переименовании общего состояния.
+	/**
+	Общие состояния (QD_OBJ_STATE_FLAG_GLOBAL_OWNER) есть и у глобального
+	объекта-владельца, и у его копий в сценах.
+	*/
+	static void drop_shared_state_indices() {
+		_shared_state_epoch++;
+	}
 
 	//! Установка владельца состояний.
 	void set_states_owner();
@@ -145,7 +164,10 @@ public:
 	}
 
 	void set_queued_state(qdGameObjectState *st) {
-		_queued_state = st;
+		if (_queued_state != st) {
+			_queued_state = st;
+			touch();
+		}
 	}
 
 	qdGameObjectState *queued_state() {
@@ -293,6 +315,9 @@ public:
 	const grScreenRegion &last_screen_region() const {
 		return _last_screen_region;
 	}
+	void move_last_screen_region(int dx, int dy) {
+		_last_screen_region.move(dx, dy);
+	}
 	virtual grScreenRegion screen_region() const;
 
 	int inventory_cell_index() const {
@@ -326,8 +351,12 @@ protected:
 	bool save_script_body(Common::WriteStream &fh, int indent = 0) const;
 
 	void set_last_state(qdGameObjectState *p) {
-		if (!p || !p->check_flag(qdGameObjectState::QD_OBJ_STATE_FLAG_MOUSE_STATE | qdGameObjectState::QD_OBJ_STATE_FLAG_MOUSE_HOVER_STATE))
-			_last_state = p;
+		if (!p || !p->check_flag(qdGameObjectState::QD_OBJ_STATE_FLAG_MOUSE_STATE | qdGameObjectState::QD_OBJ_STATE_FLAG_MOUSE_HOVER_STATE)) {
+			if (_last_state != p) {
+				_last_state = p;
+				touch();
+			}
+		}
 	}
 
 	void set_last_inventory_state(qdGameObjectState *p) {
@@ -383,7 +412,17 @@ private:
 	//! Прозрачность затенения, значения - [0, 255], если равно QD_NO_SHADOW_ALPHA, то персонаж не затеняется.
 	int _shadow_alpha;
 
+	//! Индекс состояний по идентификаторам имен - номер первого состояния с таким именем.
+	typedef Common::HashMap<qdNameAtom, int> state_index_t;
+	mutable state_index_t _state_index;
+	mutable bool _state_index_valid;
+	//! Значение _shared_state_epoch при построении индекса.
+	mutable uint32 _state_index_epoch;
+
+	static uint32 _shared_state_epoch;
+
 	void clear_states();
+	void build_state_index() const;
 };
 
 } // namespace QDEngine
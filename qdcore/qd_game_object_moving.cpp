@@ -1308,6 +1308,8 @@ bool qdGameObjectMoving::hit(int x, int y) const {
 }
 
 void qdGameObjectMoving::set_state(int st) {
+	qdGameScene::invalidate_pick_grid();
+
 	// Указание на смену состояния => объект меняется (устанавливаем время изм.)
 	set_last_chg_time(qdGameDispatcher::get_dispatcher()->get_time());
 
@@ -688,6 +688,14 @@ bool qdGameObjectState::need_sound_restart() const {
 	return false;
 }
 
+void qdGameObjectState::name_changed() {
+	// общее состояние хранится и у копий объекта в сценах, владельцем которых не является
+	if (check_flag(QD_OBJ_STATE_FLAG_GLOBAL_OWNER))
+		qdGameObjectAnimated::drop_shared_state_indices();
+	else if (owner())
+		static_cast<qdGameObjectAnimated *>(owner())->drop_state_index();
+}
+
 const char *qdGameObjectState::full_text() const {
 	return qdTextDB::instance().getText(_text_ID.c_str());
 }
@@ -580,6 +580,9 @@ protected:
 	//! Возвращает true, если надо перезапустить звук.
 	virtual bool need_sound_restart() const;
 
+	//! Сбрасывает индекс состояний владельца, для общих состояний - всех объектов.
+	virtual void name_changed();
+
 private:
 
 	//! Тип состояния.
@@ -22,6 +22,8 @@
 #include "common/debug.h"
 #include "common/stream.h"
 
+#include "graphics/managed_surface.h"
+
 #include "qdengine/qdengine.h"
 #include "qdengine/qd_fwd.h"
 #include "qdengine/system/graphics/gr_dispatcher.h"
@@ -51,11 +53,36 @@ struct qdGridZoneOrdering {
 	}
 };
 
+static inline bool is_pickable(const qdGameObject *obj) {
+	return !obj->check_flag(QD_OBJ_DISABLE_MOUSE_FLAG) && obj->named_object_type() != QD_NAMED_OBJECT_STATIC_OBJ;
+}
+
 fpsCounter qdGameScene::_fps_counter = fpsCounter(1000);
 grScreenRegion qdGameScene::_fps_region = grScreenRegion::EMPTY;
 grScreenRegion qdGameScene::_fps_region_last = grScreenRegion::EMPTY;
 char qdGameScene::_fps_string[255];
 Std::vector<qdGameObject *> qdGameScene::_visible_objects;
+bool qdGameScene::_visible_bins_valid = false;
+int qdGameScene::_visible_bins_sx = 0;
+int qdGameScene::_visible_bins_sy = 0;
+Std::vector<int> qdGameScene::_visible_bins_start;
+Std::vector<int> qdGameScene::_visible_bins;
+Std::vector<int> qdGameScene::_visible_bin_rects;
+Std::vector<uint32> qdGameScene::_visible_marks;
+uint32 qdGameScene::_visible_mark = 0;
+Std::vector<int> qdGameScene::_visible_query;
+uint32 qdGameScene::_redraw_objects_drawn = 0;
+uint32 qdGameScene::_redraw_objects_skipped = 0;
+bool qdGameScene::_pick_grid_valid = false;
+bool qdGameScene::_pick_grid_dirty = true;
+int qdGameScene::_pick_grid_sx = 0;
+int qdGameScene::_pick_grid_sy = 0;
+Std::vector<Std::vector<int> > qdGameScene::_pick_cells;
+Std::vector<int> qdGameScene::_pick_rects;
+Std::vector<qdGameObject *> qdGameScene::_pick_objects;
+Std::vector<int> qdGameScene::_pick_query;
+uint32 qdGameScene::_pick_objects_tested = 0;
+uint32 qdGameScene::_pick_objects_skipped = 0;
 
 qdGameScene::qdGameScene() : _mouse_click_object(NULL),
 	_mouse_right_click_object(NULL),
@@ -63,7 +90,10 @@ qdGameScene::qdGameScene() : _mouse_click_object(NULL),
 	_selected_object(NULL),
 	_mouse_click_pos(0, 0),
 	_zone_update_count(0),
-	_minigame(NULL) {
+	_minigame(NULL),
+	_static_layer(NULL),
+	_static_layer_count(0),
+	_static_layer_scroll(0, 0) {
 	set_loading_progress_callback(NULL);
 
 	_restart_minigame_on_load = false;
@@ -73,6 +103,7 @@ qdGameScene::qdGameScene() : _mouse_click_object(NULL),
 
 qdGameScene::~qdGameScene() {
 	_grid_zones.clear();
+	free_static_layer();
 }
 
 void qdGameScene::init_objects_grid() {
@@ -105,10 +136,11 @@ void qdGameScene::quant(float dt) {
 	follow_quant(dt);
 	collision_quant();
 
+	Vect2i camera_center = _camera.get_scr_center();
 	if (_camera.quant(dt)) {
 		if (qdGameDispatcher *dp = qdGameDispatcher::get_dispatcher()) {
 			debugC(3, kDebugQuant, "qdGameScene::quant(%f) _camera", dt);
-			dp->toggle_full_redraw();
+			dp->scroll_screen(_camera.get_scr_center() - camera_center);
 		}
 	}
 
@@ -150,6 +182,9 @@ void qdGameScene::quant(float dt) {
 			(*io)->quant(dt);
 	}
 
+	// кадры анимаций сменились
+	_pick_grid_dirty = true;
+
 	update_mouse_cursor();
 
 	if (_selected_object && !_selected_object->is_visible()) {
@@ -220,11 +255,281 @@ void qdGameScene::redraw() {
 				}
 				break;
 			}
-		} else {
+		} else if (g_engine->_debugDraw) {
 			for (Std::vector<qdGameObject *>::reverse_iterator it = _visible_objects.rbegin(); it != _visible_objects.rend(); ++it)
 				(*it)->redraw();
+		} else
+			redraw_visible_bins();
+	}
+}
+
+void qdGameScene::build_visible_bins() {
+	const int sx = grDispatcher::instance()->get_SizeX();
+	const int sy = grDispatcher::instance()->get_SizeY();
+
+	_visible_bins_sx = (sx >> VISIBLE_BIN_SHIFT) + 1;
+	_visible_bins_sy = (sy >> VISIBLE_BIN_SHIFT) + 1;
+
+	_visible_bins_start.resize(_visible_bins_sx * _visible_bins_sy + 1);
+	Common::fill(_visible_bins_start.begin(), _visible_bins_start.end(), 0);
+
+	_visible_bin_rects.resize(_visible_objects.size() * 4);
+
+	for (uint i = 0; i < _visible_objects.size(); i++) {
+		int *rect = &_visible_bin_rects[i * 4];
+
+		grScreenRegion reg = _visible_objects[i]->screen_region();
+		if (reg.is_empty()) {
+			// область неизвестна - объект выводится всегда
+			rect[0] = rect[1] = 0;
+			rect[2] = _visible_bins_sx - 1;
+			rect[3] = _visible_bins_sy - 1;
+		} else {
+			int x0 = MAX(reg.min_x() - 1, 0);
+			int y0 = MAX(reg.min_y() - 1, 0);
+			int x1 = MIN(reg.max_x() + 1, sx - 1);
+			int y1 = MIN(reg.max_y() + 1, sy - 1);
+
+			if (x0 > x1 || y0 > y1) {
+				rect[0] = rect[1] = 0;
+				rect[2] = rect[3] = -1;
+				continue;
+			}
+
+			rect[0] = x0 >> VISIBLE_BIN_SHIFT;
+			rect[1] = y0 >> VISIBLE_BIN_SHIFT;
+			rect[2] = x1 >> VISIBLE_BIN_SHIFT;
+			rect[3] = y1 >> VISIBLE_BIN_SHIFT;
+		}
+
+		for (int y = rect[1]; y <= rect[3]; y++) {
+			for (int x = rect[0]; x <= rect[2]; x++)
+				_visible_bins_start[y * _visible_bins_sx + x + 1]++;
+		}
+	}
+
+	for (uint i = 1; i < _visible_bins_start.size(); i++)
+		_visible_bins_start[i] += _visible_bins_start[i - 1];
+
+	_visible_bins.resize(_visible_bins_start.back());
+
+	// _visible_query временно хранит позиции заполнения клеток
+	_visible_query.assign(_visible_bins_start.begin(), _visible_bins_start.end() - 1);
+
+	for (uint i = 0; i < _visible_objects.size(); i++) {
+		const int *rect = &_visible_bin_rects[i * 4];
+		for (int y = rect[1]; y <= rect[3]; y++) {
+			for (int x = rect[0]; x <= rect[2]; x++)
+				_visible_bins[_visible_query[y * _visible_bins_sx + x]++] = i;
+		}
+	}
+
+	_visible_marks.resize(_visible_objects.size());
+	Common::fill(_visible_marks.begin(), _visible_marks.end(), 0);
+	_visible_mark = 0;
+
+	_visible_bins_valid = true;
+
+	update_static_layer();
+}
+
+namespace {
+
+/// Объект, который можно вывести в слой неподвижных объектов.
+bool is_static_layer_object(const qdGameObject *p) {
+	switch (p->named_object_type()) {
+	case QD_NAMED_OBJECT_STATIC_OBJ:
+		return true;
+	case QD_NAMED_OBJECT_ANIMATED_OBJ: {
+		const qdGameObjectAnimated *obj = static_cast<const qdGameObjectAnimated *>(p);
+		return !obj->has_screen_transform() && obj->shadow_alpha() == QD_NO_SHADOW_ALPHA &&
+		       !obj->get_animation()->is_empty() && obj->get_animation()->num_frames() == 1;
+	}
+	default:
+		return false;
+	}
+}
+
+} // namespace
+
+void qdGameScene::update_static_layer() {
+	// В слой выводятся неподвижные объекты, которые рисуются раньше всех
+	// остальных, так что порядок вывода по глубине не меняется.
+	int count = 0;
+	for (Std::vector<qdGameObject *>::reverse_iterator it = _visible_objects.rbegin(); it != _visible_objects.rend(); ++it) {
+		if (!is_static_layer_object(*it))
+			break;
+		count++;
+	}
+
+	Vect2i scroll = _static_layer_scroll;
+	_static_layer_scroll = Vect2i(0, 0);
+
+	if (!count) {
+		_static_layer_count = 0;
+		return;
+	}
+
+	const int sx = grDispatcher::instance()->get_SizeX();
+	const int sy = grDispatcher::instance()->get_SizeY();
+
+	bool is_valid = _static_layer && _static_layer_count == count && _static_layer->w == sx && _static_layer->h == sy;
+
+	_static_layer_keys.resize(count);
+
+	for (int i = 0; i < count; i++) {
+		const qdGameObject *obj = _visible_objects[_visible_objects.size() - 1 - i];
+
+		StaticLayerKey key;
+		key.object = obj;
+		key.pos = obj->screen_pos();
+		if (obj->named_object_type() == QD_NAMED_OBJECT_ANIMATED_OBJ) {
+			const qdAnimation *anm = static_cast<const qdGameObjectAnimated *>(obj)->get_animation();
+			key.frame = anm->get_cur_frame();
+			key.flags = anm->flags();
+		} else {
+			key.frame = NULL;
+			key.flags = 0;
+		}
+
+		// при прокрутке экрана слой сдвигается вместе с ним
+		_static_layer_keys[i].pos += scroll;
+
+		if (!(_static_layer_keys[i] == key)) {
+			_static_layer_keys[i] = key;
+			is_valid = false;
+		}
+	}
+
+	if (is_valid && !scroll.x && !scroll.y)
+		return;
+
+	int left, top, right, bottom;
+	grDispatcher::instance()->getClip(left, top, right, bottom);
+
+	if (is_valid) {
+		debugC(3, kDebugGraphics, "qdGameScene::update_static_layer(): scroll %d %d", scroll.x, scroll.y);
+
+		grDispatcher::instance()->set_draw_surface(_static_layer);
+		grDispatcher::instance()->scroll(scroll.x, scroll.y);
+
+		// открывшиеся полосы
+		int strips[2][4] = {
+			{ scroll.x > 0 ? 0 : sx + scroll.x, 0, scroll.x > 0 ? scroll.x : sx, sy },
+			{ 0, scroll.y > 0 ? 0 : sy + scroll.y, sx, scroll.y > 0 ? scroll.y : sy }
+		};
+
+		for (int i = 0; i < 2; i++) {
+			if (strips[i][0] >= strips[i][2] || strips[i][1] >= strips[i][3])
+				continue;
+
+			grDispatcher::instance()->setClip(strips[i][0], strips[i][1], strips[i][2], strips[i][3]);
+			grDispatcher::instance()->erase(strips[i][0], strips[i][1], strips[i][2] - strips[i][0], strips[i][3] - strips[i][1], 0);
+
+			for (int j = 0; j < count; j++)
+				_visible_objects[_visible_objects.size() - 1 - j]->redraw();
+		}
+
+		grDispatcher::instance()->set_draw_surface(NULL);
+		grDispatcher::instance()->setClip(left, top, right, bottom);
+		return;
+	}
+
+	debugC(3, kDebugGraphics, "qdGameScene::update_static_layer(): %d objects", count);
+
+	if (_static_layer && (_static_layer->w != sx || _static_layer->h != sy)) {
+		delete _static_layer;
+		_static_layer = NULL;
+	}
+
+	if (!_static_layer)
+		_static_layer = grDispatcher::instance()->create_layer();
+
+	grDispatcher::instance()->set_draw_surface(_static_layer);
+	grDispatcher::instance()->setClip();
+	grDispatcher::instance()->fill(0);
+
+	for (int i = 0; i < count; i++)
+		_visible_objects[_visible_objects.size() - 1 - i]->redraw();
+
+	grDispatcher::instance()->set_draw_surface(NULL);
+	grDispatcher::instance()->setClip(left, top, right, bottom);
+
+	_static_layer_count = count;
+}
+
+void qdGameScene::scroll_screen(int dx, int dy) {
+	for (qdGameObjectList::const_iterator io = object_list().begin(); io != object_list().end(); ++io) {
+		if (!(*io)->check_flag(QD_OBJ_IS_IN_INVENTORY_FLAG))
+			(*io)->move_last_screen_region(dx, dy);
+	}
+
+	_fps_region_last.move(dx, dy);
+
+	_static_layer_scroll += Vect2i(dx, dy);
+}
+
+void qdGameScene::free_static_layer() {
+	delete _static_layer;
+	_static_layer = NULL;
+
+	_static_layer_keys.clear();
+	_static_layer_count = 0;
+	_static_layer_scroll = Vect2i(0, 0);
+}
+
+void qdGameScene::redraw_visible_bins() {
+	if (!_visible_bins_valid)
+		build_visible_bins();
+
+	int left, top, right, bottom;
+	grDispatcher::instance()->getClip(left, top, right, bottom);
+
+	if (right <= left || bottom <= top)
+		return;
+
+	int x0 = MAX(left, 0) >> VISIBLE_BIN_SHIFT;
+	int y0 = MAX(top, 0) >> VISIBLE_BIN_SHIFT;
+	int x1 = MIN((right - 1) >> VISIBLE_BIN_SHIFT, _visible_bins_sx - 1);
+	int y1 = MIN((bottom - 1) >> VISIBLE_BIN_SHIFT, _visible_bins_sy - 1);
+
+	if (!++_visible_mark) {
+		Common::fill(_visible_marks.begin(), _visible_marks.end(), 0);
+		_visible_mark = 1;
+	}
+
+	_visible_query.clear();
+
+	for (int y = y0; y <= y1; y++) {
+		for (int x = x0; x <= x1; x++) {
+			int cell = y * _visible_bins_sx + x;
+			for (int i = _visible_bins_start[cell]; i < _visible_bins_start[cell + 1]; i++) {
+				int idx = _visible_bins[i];
+				if (_visible_marks[idx] != _visible_mark) {
+					_visible_marks[idx] = _visible_mark;
+					_visible_query.push_back(idx);
+				}
+			}
 		}
 	}
+
+	// объекты выводятся в том же порядке, что и без сетки - от дальних к ближним
+	Common::sort(_visible_query.begin(), _visible_query.end(), Common::Greater<int>());
+
+	uint start = 0;
+	if (_static_layer_count) {
+		grDispatcher::instance()->put_layer(_static_layer, left, top, right - left, bottom - top);
+
+		int layer_start = _visible_objects.size() - _static_layer_count;
+		while (start < _visible_query.size() && _visible_query[start] >= layer_start)
+			start++;
+	}
+
+	for (uint i = start; i < _visible_query.size(); i++)
+		_visible_objects[_visible_query[i]]->redraw();
+
+	_redraw_objects_drawn += _visible_query.size() - start;
+	_redraw_objects_skipped += _visible_objects.size() - (_visible_query.size() - start);
 }
 
 bool qdGameScene::mouse_handler(int x, int y, mouseDispatcher::mouseEvent ev) {
@@ -241,14 +546,8 @@ bool qdGameScene::mouse_handler(int x, int y, mouseDispatcher::mouseEvent ev) {
 				break;
 			}
 		}
-		for (Std::vector<qdGameObject *>::iterator io = _visible_objects.begin(); io != _visible_objects.end(); ++io) {
-			if (!(*io)->check_flag(QD_OBJ_DISABLE_MOUSE_FLAG) && (*io)->named_object_type() != QD_NAMED_OBJECT_STATIC_OBJ) {
-				if ((*io)->hit(x, y)) {
-					_mouse_hover_object = *io;
-					break;
-				}
-			}
-		}
+		if (qdGameObject *pObj = get_hitted_obj(x, y))
+			_mouse_hover_object = pObj;
 		break;
 	case mouseDispatcher::EV_LEFT_DOWN:
 	case mouseDispatcher::EV_RIGHT_DOWN: {
@@ -276,12 +575,134 @@ bool qdGameScene::mouse_handler(int x, int y, mouseDispatcher::mouseEvent ev) {
 }
 
 qdGameObject *qdGameScene::get_hitted_obj(int x, int y) {
-	for (Std::vector<qdGameObject *>::iterator io = _visible_objects.begin(); io != _visible_objects.end(); ++io) {
-		if (!(*io)->check_flag(QD_OBJ_DISABLE_MOUSE_FLAG) && (*io)->named_object_type() != QD_NAMED_OBJECT_STATIC_OBJ)
-			if ((*io)->hit(x, y))
-				return (*io);
+	if (_pick_grid_dirty || !_pick_grid_valid)
+		update_pick_grid();
+
+	if (x < 0 || y < 0 || (x >> VISIBLE_BIN_SHIFT) >= _pick_grid_sx || (y >> VISIBLE_BIN_SHIFT) >= _pick_grid_sy) {
+		// точка вне сетки - проверяем все объекты
+		for (Std::vector<qdGameObject *>::iterator io = _visible_objects.begin(); io != _visible_objects.end(); ++io) {
+			if (is_pickable(*io))
+				if ((*io)->hit(x, y))
+					return (*io);
+		}
+		return NULL;
+	}
+
+	const Std::vector<int> &cell = _pick_cells[(y >> VISIBLE_BIN_SHIFT) * _pick_grid_sx + (x >> VISIBLE_BIN_SHIFT)];
+
+	// объекты проверяются в том же порядке, что и без сетки - от ближних к дальним
+	_pick_query.assign(cell.begin(), cell.end());
+	Common::sort(_pick_query.begin(), _pick_query.end());
+
+	qdGameObject *result = NULL;
+
+	uint tested = 0;
+	for (; tested < _pick_query.size(); tested++) {
+		qdGameObject *obj = _pick_objects[_pick_query[tested]];
+		if (is_pickable(obj) && obj->hit(x, y)) {
+			result = obj;
+			tested++;
+			break;
+		}
 	}
-	return NULL;
+
+	_pick_objects_tested += tested;
+	_pick_objects_skipped += _pick_objects.size() - _pick_query.size();
+
+	return result;
+}
+
+void qdGameScene::pick_cells(const qdGameObject *obj, int *rect) const {
+	rect[0] = rect[1] = 0;
+	rect[2] = rect[3] = -1;
+
+	if (obj->named_object_type() == QD_NAMED_OBJECT_STATIC_OBJ || !obj->is_visible())
+		return;
+
+	grScreenRegion reg = obj->screen_region();
+
+	bool everywhere = reg.is_empty();
+	if (obj->named_object_type() == QD_NAMED_OBJECT_ANIMATED_OBJ || obj->named_object_type() == QD_NAMED_OBJECT_MOVING_OBJ) {
+		// у маски своя форма, не связанная с областью объекта на экране
+		const qdGameObjectState *st = static_cast<const qdGameObjectAnimated *>(obj)->get_cur_state();
+		if (st && st->state_type() == qdGameObjectState::STATE_MASK)
+			everywhere = true;
+	}
+
+	if (everywhere) {
+		rect[2] = _pick_grid_sx - 1;
+		rect[3] = _pick_grid_sy - 1;
+		return;
+	}
+
+	const int sx = _pick_grid_sx << VISIBLE_BIN_SHIFT;
+	const int sy = _pick_grid_sy << VISIBLE_BIN_SHIFT;
+
+	int x0 = MAX(reg.min_x() - 1, 0);
+	int y0 = MAX(reg.min_y() - 1, 0);
+	int x1 = MIN(reg.max_x() + 1, sx - 1);
+	int y1 = MIN(reg.max_y() + 1, sy - 1);
+
+	if (x0 > x1 || y0 > y1)
+		return;
+
+	rect[0] = x0 >> VISIBLE_BIN_SHIFT;
+	rect[1] = y0 >> VISIBLE_BIN_SHIFT;
+	rect[2] = x1 >> VISIBLE_BIN_SHIFT;
+	rect[3] = y1 >> VISIBLE_BIN_SHIFT;
+}
+
+void qdGameScene::update_pick_grid() {
+	if (!_pick_grid_valid || _pick_objects != _visible_objects) {
+		_pick_grid_sx = (grDispatcher::instance()->get_SizeX() >> VISIBLE_BIN_SHIFT) + 1;
+		_pick_grid_sy = (grDispatcher::instance()->get_SizeY() >> VISIBLE_BIN_SHIFT) + 1;
+
+		_pick_cells.resize(_pick_grid_sx * _pick_grid_sy);
+		for (uint i = 0; i < _pick_cells.size(); i++)
+			_pick_cells[i].clear();
+
+		_pick_objects = _visible_objects;
+
+		_pick_rects.resize(_pick_objects.size() * 4);
+		for (uint i = 0; i < _pick_objects.size(); i++) {
+			int *rect = &_pick_rects[i * 4];
+			rect[0] = rect[1] = 0;
+			rect[2] = rect[3] = -1;
+		}
+
+		_pick_grid_valid = true;
+	}
+
+	for (uint i = 0; i < _pick_objects.size(); i++) {
+		int rect[4];
+		pick_cells(_pick_objects[i], rect);
+
+		int *old_rect = &_pick_rects[i * 4];
+		if (rect[0] == old_rect[0] && rect[1] == old_rect[1] && rect[2] == old_rect[2] && rect[3] == old_rect[3])
+			continue;
+
+		for (int y = old_rect[1]; y <= old_rect[3]; y++) {
+			for (int x = old_rect[0]; x <= old_rect[2]; x++) {
+				Std::vector<int> &cell = _pick_cells[y * _pick_grid_sx + x];
+				for (uint j = 0; j < cell.size(); j++) {
+					if (cell[j] == (int)i) {
+						cell[j] = cell.back();
+						cell.pop_back();
+						break;
+					}
+				}
+			}
+		}
+
+		for (int y = rect[1]; y <= rect[3]; y++) {
+			for (int x = rect[0]; x <= rect[2]; x++)
+				_pick_cells[y * _pick_grid_sx + x].push_back(i);
+		}
+
+		memcpy(old_rect, rect, sizeof(rect));
+	}
+
+	_pick_grid_dirty = false;
 }
 
 void qdGameScene::load_script(const xml::tag *p) {
@@ -460,6 +881,8 @@ void qdGameScene::free_resources() {
 		io->free_resources();
 	}
 
+	free_static_layer();
+
 	qdGameDispatcherBase::free_resources();
 }
 
@@ -559,6 +982,8 @@ bool qdGameScene::deactivate() {
 	if (_minigame)
 		_minigame->end();
 
+	_pick_grid_valid = false;
+
 	return true;
 }
 
@@ -631,6 +1056,8 @@ bool qdGameScene::init_visible_objects_list() {
 	}
 
 	Common::sort(_visible_objects.begin(), _visible_objects.end(), qdObjectOrdering());
+	_visible_bins_valid = false;
+	_pick_grid_dirty = true;
 
 	return true;
 }
@@ -37,6 +37,10 @@ namespace Common {
 class WriteStream;
 }
 
+namespace Graphics {
+class ManagedSurface;
+}
+
 namespace QDEngine {
 
 class qdMiniGame;
@@ -220,6 +224,42 @@ public:
 		return _fps_counter;
 	}
 
+	//! Статистика перерисовки по областям: сколько объектов выведено и сколько пропущено.
+	static uint32 redraw_objects_drawn() {
+		return _redraw_objects_drawn;
+	}
+	static uint32 redraw_objects_skipped() {
+		return _redraw_objects_skipped;
+	}
+	static void reset_redraw_stats() {
+		_redraw_objects_drawn = _redraw_objects_skipped = 0;
+	}
+
+	//! Статистика поиска объектов под мышью: сколько объектов проверено и сколько отброшено сеткой.
+	static uint32 pick_objects_tested() {
+		return _pick_objects_tested;
+	}
+	static uint32 pick_objects_skipped() {
+		return _pick_objects_skipped;
+	}
+	static void reset_pick_stats() {
+		_pick_objects_tested = _pick_objects_skipped = 0;
+	}
+	//! Сетка поиска объектов под мышью обновится при следующем запросе.
+	/**
+	Вызывается при изменении положения, состояния или видимости объектов.
+	*/
+	static void invalidate_pick_grid() {
+		_pick_grid_dirty = true;
+	}
+
+	//! Учитывает сдвиг изображения на экране при прокрутке камеры.
+	/**
+	Запомненные области объектов сдвигаются вслед за изображением,
+	так что перерисовываются только объекты, сдвинувшиеся относительно сцены.
+	*/
+	void scroll_screen(int dx, int dy);
+
 	int autosave_slot() const {
 		return _autosave_slot;
 	}
@@ -290,12 +330,87 @@ private:
 
 	static Std::vector<qdGameObject *> _visible_objects;
 
+	enum {
+		/// размер клетки сетки видимых объектов - 64 пиксела
+		VISIBLE_BIN_SHIFT = 6
+	};
+
+	/// Сетка экрана с номерами видимых объектов, попадающих в клетки.
+	/**
+	Строится при первой перерисовке после init_visible_objects_list(),
+	объекты клетки [i] - _visible_bins[_visible_bins_start[i]..._visible_bins_start[i + 1]),
+	по возрастанию номера в _visible_objects.
+	*/
+	static bool _visible_bins_valid;
+	static int _visible_bins_sx;
+	static int _visible_bins_sy;
+	static Std::vector<int> _visible_bins_start;
+	static Std::vector<int> _visible_bins;
+	/// клетки, занятые объектами, по четыре числа на объект
+	static Std::vector<int> _visible_bin_rects;
+	static Std::vector<uint32> _visible_marks;
+	static uint32 _visible_mark;
+	static Std::vector<int> _visible_query;
+
+	static uint32 _redraw_objects_drawn;
+	static uint32 _redraw_objects_skipped;
+
+	/// Сетка экрана для поиска объектов под мышью.
+	/**
+	Клетки того же размера, что и у сетки перерисовки.
+	Обновляется при первом запросе после invalidate_pick_grid(): клетки
+	объектов пересчитываются по screen_region(), в сетке перемещаются
+	только объекты, клетки которых изменились. Полностью перестраивается
+	при изменении списка видимых объектов.
+	*/
+	static bool _pick_grid_valid;
+	static bool _pick_grid_dirty;
+	static int _pick_grid_sx;
+	static int _pick_grid_sy;
+	/// номера объектов в клетках, в произвольном порядке
+	static Std::vector<Std::vector<int> > _pick_cells;
+	/// клетки, занятые объектами, по четыре числа на объект
+	static Std::vector<int> _pick_rects;
+	/// список видимых объектов, по которому построена сетка
+	static Std::vector<qdGameObject *> _pick_objects;
+	static Std::vector<int> _pick_query;
+
+	static uint32 _pick_objects_tested;
+	static uint32 _pick_objects_skipped;
+
+	/// Слой с дальними неподвижными объектами, см. update_static_layer().
+	Graphics::ManagedSurface *_static_layer;
+
+	struct StaticLayerKey {
+		const qdGameObject *object;
+		Vect2i pos;
+		const void *frame;
+		int flags;
+
+		bool operator == (const StaticLayerKey &key) const {
+			return object == key.object && pos == key.pos && frame == key.frame && flags == key.flags;
+		}
+	};
+
+	/// объекты слоя в порядке вывода и их состояние на момент построения слоя
+	Std::vector<StaticLayerKey> _static_layer_keys;
+	/// сколько последних объектов _visible_objects выведено в слой
+	int _static_layer_count;
+	/// сдвиг экрана, ещё не применённый к слою
+	Vect2i _static_layer_scroll;
+
 	static fpsCounter _fps_counter;
 	static grScreenRegion _fps_region;
 	static grScreenRegion _fps_region_last;
 	static char _fps_string[255];
 
 	bool init_visible_objects_list();
+	void build_visible_bins();
+	void redraw_visible_bins();
+	void update_pick_grid();
+	void pick_cells(const qdGameObject *obj, int *rect) const;
+	void update_static_layer();
+	void free_static_layer();
 	void update_mouse_cursor();
 
 	void personages_quant();
@@ -0,0 +1,111 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/debug.h"
+
+#include "qdengine/qdengine.h"
+#include "qdengine/qdcore/qd_sprite.h"
+#include "qdengine/qdcore/qd_hit_mask_cache.h"
+
+
+namespace QDEngine {
+
+qdHitMaskCache qdHitMaskCache::_instance;
+
+qdHitMaskCache::qdHitMaskCache() : qdMemoryCache("hitmask") {
+}
+
+qdHitMaskCache::~qdHitMaskCache() {
+	clear();
+}
+
+bool qdHitMaskCache::get(const qdSprite *sprite, qdHitMask &mask) {
+	if (!memoryLimit())
+		return false;
+
+	SpriteMap::const_iterator it = _spriteMap.find(sprite);
+	if (it != _spriteMap.end()) {
+		MaskEntry *p = it->_value;
+		hit(p);
+
+		mask.stride = p->stride;
+		mask.bits = p->bits;
+		return true;
+	}
+
+	miss();
+
+	if (!sprite->data() && !sprite->is_compressed())
+		return false;
+
+	int sx = sprite->picture_size_x();
+	int sy = sprite->picture_size_y();
+	if (sx <= 0 || sy <= 0)
+		return false;
+
+	int stride = (sx + 31) >> 5;
+	uint32 size = stride * sy * sizeof(uint32) + sizeof(MaskEntry);
+	if (!reserve(size))
+		return false;
+
+	uint32 *bits = new uint32[stride * sy];
+	if (!sprite->build_hit_mask(bits, stride)) {
+		delete [] bits;
+		return false;
+	}
+
+	debugC(3, kDebugGraphics, "qdHitMaskCache::get(): %d x %d, %u bytes", sx, sy, size);
+
+	MaskEntry *p = new MaskEntry;
+	p->sprite = sprite;
+	p->stride = stride;
+	p->bits = bits;
+	p->size = size;
+
+	_spriteMap[sprite] = p;
+	insert(p);
+
+	mask.stride = stride;
+	mask.bits = bits;
+	return true;
+}
+
+void qdHitMaskCache::release(const qdSprite *sprite) {
+	if (!entryCount())
+		return;
+
+	SpriteMap::iterator it = _spriteMap.find(sprite);
+	if (it == _spriteMap.end())
+		return;
+
+	remove(it->_value);
+}
+
+void qdHitMaskCache::detach(Entry *p) {
+	_spriteMap.erase(static_cast<MaskEntry *>(p)->sprite);
+}
+
+void qdHitMaskCache::detachAll() {
+	_spriteMap.clear(true);
+}
+
+} // namespace QDEngine
@@ -0,0 +1,91 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef QDENGINE_QDCORE_QD_HIT_MASK_CACHE_H
+#define QDENGINE_QDCORE_QD_HIT_MASK_CACHE_H
+
+#include "common/hashmap.h"
+
+#include "qdengine/qdcore/qd_memory_cache.h"
+
+namespace QDEngine {
+
+class qdSprite;
+
+//! Маска непрозрачности спрайта, один бит на пиксел.
+struct qdHitMask {
+	/// Длина строки маски в 32-битных словах.
+	int stride;
+	const uint32 *bits;
+
+	bool test(int x, int y) const {
+		return (bits[y * stride + (x >> 5)] >> (x & 31)) & 1;
+	}
+};
+
+//! Кэш масок непрозрачности для проверки попадания мышью.
+/**
+Маска строится при первой проверке попадания в спрайт по тем же
+правилам, что и qdSprite::hit(), и дальше проверка стоит
+одного обращения к памяти.
+Общий для всех спрайтов, ограничен по памяти.
+*/
+class qdHitMaskCache : public qdMemoryCache {
+public:
+	qdHitMaskCache();
+	~qdHitMaskCache();
+
+	static qdHitMaskCache &instance() {
+		return _instance;
+	}
+
+	/// Возвращает маску спрайта или false, если маску построить нельзя.
+	bool get(const qdSprite *sprite, qdHitMask &mask);
+
+	/// Удаляет маску спрайта, вызывается при изменении или освобождении его данных.
+	void release(const qdSprite *sprite);
+
+private:
+	struct MaskEntry : public Entry {
+		MaskEntry() : sprite(0), stride(0), bits(0) { }
+		~MaskEntry() {
+			delete [] bits;
+		}
+
+		const qdSprite *sprite;
+		int stride;
+		uint32 *bits;
+	};
+
+	typedef Common::HashMap<const qdSprite *, MaskEntry *, PointerHash> SpriteMap;
+
+	SpriteMap _spriteMap;
+
+	void detach(Entry *p);
+	void detachAll();
+
+	static qdHitMaskCache _instance;
+};
+
+} // namespace QDEngine
+
+#endif // QDENGINE_QDCORE_QD_HIT_MASK_CACHE_H
@@ -66,7 +66,7 @@ public:
 	//! Возвращает true, если экран есть в списке.
 	bool is_screen_in_list(const qdInterfaceScreen *scr);
 
-	typedef Std::list<qdInterfaceScreen *> screen_list_t;
+	typedef Std::vector<qdInterfaceScreen *> screen_list_t;
 	//! Возвращает список экранов.
 	const screen_list_t &screen_list() const {
 		return _screens.get_list();
@@ -194,6 +194,11 @@ public:
 		_save_font_color = clr;
 	}
 
+	//! Перерисовать при следующей отрисовке все элементы интерфейса.
+	void toggle_full_redraw() {
+		_need_full_redraw = true;
+	}
+
 	//! Возвращает true, если интерфейс отрисовывается поверх сцены.
 	bool need_scene_redraw() const {
 		return _need_scene_redraw;
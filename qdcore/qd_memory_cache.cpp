@@ -0,0 +1,166 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/debug.h"
+
+#include "qdengine/qdengine.h"
+#include "qdengine/qdcore/qd_memory_cache.h"
+
+
+namespace QDEngine {
+
+qdMemoryCache *qdMemoryCache::_first = 0;
+
+qdMemoryCache::qdMemoryCache(const char *name) : _name(name),
+	_memoryLimit(0),
+	_memoryUsed(0),
+	_head(0),
+	_tail(0),
+	_entryCount(0),
+	_pinned(false),
+	_pinGeneration(0) {
+	resetStats();
+
+	_next = _first;
+	_first = this;
+}
+
+qdMemoryCache::~qdMemoryCache() {
+	// элементы освобождает наследник через clear(), пока его detachAll() ещё доступен
+	assert(!_head);
+
+	qdMemoryCache **p = &_first;
+	while (*p != this)
+		p = &(*p)->_next;
+
+	*p = _next;
+}
+
+qdMemoryCache *qdMemoryCache::find(const char *name) {
+	for (qdMemoryCache *p = _first; p; p = p->_next) {
+		if (!strcmp(p->_name, name))
+			return p;
+	}
+
+	return 0;
+}
+
+void qdMemoryCache::setMemoryLimit(uint32 limit) {
+	_memoryLimit = limit;
+
+	if (_memoryLimit)
+		reserve(0);
+	else
+		clear();
+
+	debugC(1, kDebugGraphics, "qdMemoryCache::setMemoryLimit(): %s, %u Kbytes", _name, limit / 1024);
+}
+
+void qdMemoryCache::clear() {
+	Entry *p = _head;
+
+	_head = _tail = 0;
+	_entryCount = 0;
+	_memoryUsed = 0;
+
+	detachAll();
+
+	while (p) {
+		Entry *next = p->next;
+		delete p;
+		p = next;
+	}
+}
+
+void qdMemoryCache::resetStats() {
+	_stats.hits = _stats.misses = _stats.evictions = 0;
+}
+
+void qdMemoryCache::hit(Entry *p) {
+	if (p != _head) {
+		unlink(p);
+		pushFront(p);
+	}
+	p->pinGeneration = _pinGeneration;
+
+	_stats.hits++;
+}
+
+bool qdMemoryCache::reserve(uint32 size) {
+	if (size > _memoryLimit)
+		return false;
+
+	while (_tail && _memoryUsed + size > _memoryLimit) {
+		// последний в списке элемент закреплен, значит закреплены все
+		if (_pinned && _tail->pinGeneration == _pinGeneration)
+			return false;
+
+		remove(_tail);
+		_stats.evictions++;
+	}
+
+	return true;
+}
+
+void qdMemoryCache::insert(Entry *p) {
+	p->pinGeneration = _pinGeneration;
+	pushFront(p);
+
+	_memoryUsed += p->size;
+	_entryCount++;
+}
+
+void qdMemoryCache::remove(Entry *p) {
+	detach(p);
+	unlink(p);
+
+	_memoryUsed -= p->size;
+	_entryCount--;
+
+	delete p;
+}
+
+void qdMemoryCache::unlink(Entry *p) {
+	if (p->prev)
+		p->prev->next = p->next;
+	else
+		_head = p->next;
+
+	if (p->next)
+		p->next->prev = p->prev;
+	else
+		_tail = p->prev;
+}
+
+void qdMemoryCache::pushFront(Entry *p) {
+	p->prev = 0;
+	p->next = _head;
+
+	if (_head)
+		_head->prev = p;
+	else
+		_tail = p;
+
+	_head = p;
+}
+
+} // namespace QDEngine
@@ -0,0 +1,165 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef QDENGINE_QDCORE_QD_MEMORY_CACHE_H
+#define QDENGINE_QDCORE_QD_MEMORY_CACHE_H
+
+#include "common/scummsys.h"
+
+namespace QDEngine {
+
+//! Базовый класс кэшей, ограниченных по памяти.
+/**
+Элементы хранятся списком в порядке использования, при нехватке
+места вытесняется элемент, который дольше всех не запрашивался.
+Поиск элементов и их данные - дело наследника.
+Все кэши собраны в список для консольной команды "caches".
+*/
+class qdMemoryCache {
+public:
+	explicit qdMemoryCache(const char *name);
+	virtual ~qdMemoryCache();
+
+	const char *name() const {
+		return _name;
+	}
+
+	/// Ограничение по памяти в байтах, 0 - кэш выключен.
+	uint32 memoryLimit() const {
+		return _memoryLimit;
+	}
+	void setMemoryLimit(uint32 limit);
+
+	uint32 memoryUsed() const {
+		return _memoryUsed;
+	}
+	int entryCount() const {
+		return _entryCount;
+	}
+
+	void clear();
+
+	/// Закрепление элементов.
+	/**
+	Элементы, запрошенные или добавленные между pin() и unpin(),
+	не вытесняются, так что указатели на их данные остаются
+	действительными до unpin().
+	*/
+	void pin() {
+		assert(!_pinned);
+		_pinned = true;
+		_pinGeneration++;
+	}
+	void unpin() {
+		_pinned = false;
+	}
+
+	struct Stats {
+		uint32 hits;
+		uint32 misses;
+		uint32 evictions;
+	};
+
+	const Stats &stats() const {
+		return _stats;
+	}
+	void resetStats();
+
+	static qdMemoryCache *first() {
+		return _first;
+	}
+	qdMemoryCache *next() const {
+		return _next;
+	}
+	/// Поиск кэша по имени, 0 если не найден.
+	static qdMemoryCache *find(const char *name);
+
+protected:
+	//! Элемент кэша, наследники добавляют в него свои данные.
+	struct Entry {
+		Entry() : size(0), pinGeneration(0), prev(0), next(0) { }
+		virtual ~Entry() { }
+
+		/// Память, занятая элементом вместе с данными.
+		uint32 size;
+		/// Значение _pinGeneration при последнем запросе элемента.
+		uint32 pinGeneration;
+
+		/// Список в порядке использования.
+		Entry *prev;
+		Entry *next;
+	};
+
+	struct PointerHash {
+		uint operator()(const void *p) const {
+			uint64 key = (uint64)(uintptr)p;
+			return (uint)((key >> 4) ^ (key >> 32)) * 2654435761U;
+		}
+	};
+
+	/// Найденный элемент переносится в начало списка.
+	void hit(Entry *p);
+	void miss() {
+		_stats.misses++;
+	}
+
+	/// Освобождает место под элемент размера size, false - элемент не помещается.
+	/**
+	Закрепленные элементы не вытесняются, см. pin().
+	*/
+	bool reserve(uint32 size);
+	/// Добавляет элемент, место под него должно быть освобождено reserve().
+	void insert(Entry *p);
+	/// Удаляет элемент из кэша и освобождает его.
+	void remove(Entry *p);
+
+	/// Удаляет элемент из поисковых структур наследника, вызывается перед освобождением.
+	virtual void detach(Entry *p) = 0;
+	/// Очищает поисковые структуры наследника, вызывается из clear().
+	virtual void detachAll() = 0;
+
+private:
+	const char *_name;
+
+	uint32 _memoryLimit;
+	uint32 _memoryUsed;
+
+	/// _head - последний запрошенный элемент.
+	Entry *_head;
+	Entry *_tail;
+	int _entryCount;
+
+	Stats _stats;
+
+	bool _pinned;
+	uint32 _pinGeneration;
+
+	qdMemoryCache *_next;
+	static qdMemoryCache *_first;
+
+	void unlink(Entry *p);
+	void pushFront(Entry *p);
+};
+
+} // namespace QDEngine
+
+#endif // QDENGINE_QDCORE_QD_MEMORY_CACHE_H
@@ -418,10 +418,7 @@ bool qdMinigameObjectInterfaceImplBase::set_state(int state_index) {
 }
 
 int qdMinigameObjectInterfaceImplBase::state_index(const char *state_name) const {
-	if (const qdGameObjectState * p = _object->get_state(state_name))
-		return _object->get_state_index(p);
-
-	return -1;
+	return _object->get_state_index(state_name);
 }
 
 mgVect3f qdMinigameObjectInterfaceImplBase::R() const {
@@ -0,0 +1,57 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "qdengine/qdcore/qd_name_atom.h"
+
+namespace QDEngine {
+
+qdNameAtomTable qdNameAtomTable::_instance;
+
+qdNameAtomTable::qdNameAtomTable() {
+}
+
+qdNameAtomTable::~qdNameAtomTable() {
+}
+
+qdNameAtom qdNameAtomTable::intern(const char *name) {
+	if (!name || !*name) return 0;
+
+	atom_map_t::const_iterator it = _atoms.find(name);
+	if (it != _atoms.end())
+		return it->_value;
+
+	qdNameAtom atom = _atoms.size() + 1;
+	_atoms[name] = atom;
+
+	return atom;
+}
+
+qdNameAtom qdNameAtomTable::find(const char *name) const {
+	if (!name || !*name) return 0;
+
+	atom_map_t::const_iterator it = _atoms.find(name);
+	if (it != _atoms.end())
+		return it->_value;
+
+	return 0;
+}
+
+} // namespace QDEngine
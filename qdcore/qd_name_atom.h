@@ -0,0 +1,71 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef QDENGINE_QDCORE_QD_NAME_ATOM_H
+#define QDENGINE_QDCORE_QD_NAME_ATOM_H
+
+#include "common/hash-str.h"
+#include "common/hashmap.h"
+#include "common/str.h"
+
+namespace QDEngine {
+
+//! Идентификатор имени объекта.
+/**
+Имена, совпадающие без учета регистра, имеют одинаковый идентификатор,
+0 - нет имени.
+*/
+typedef uint32 qdNameAtom;
+
+//! Таблица идентификаторов имен.
+/**
+Общая для всех объектов, имена из нее не удаляются.
+*/
+class qdNameAtomTable {
+public:
+	qdNameAtomTable();
+	~qdNameAtomTable();
+
+	static qdNameAtomTable &instance() {
+		return _instance;
+	}
+
+	//! Возвращает идентификатор имени, новое имя добавляется в таблицу.
+	qdNameAtom intern(const char *name);
+	//! Возвращает идентификатор имени или 0, если имени нет в таблице.
+	qdNameAtom find(const char *name) const;
+
+	//! Количество имен в таблице.
+	int size() const {
+		return _atoms.size();
+	}
+
+private:
+
+	typedef Common::HashMap<Common::String, qdNameAtom, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> atom_map_t;
+	atom_map_t _atoms;
+
+	static qdNameAtomTable _instance;
+};
+
+} // namespace QDEngine
+
+#endif // QDENGINE_QDCORE_QD_NAME_ATOM_H
@@ -27,16 +27,21 @@
 
 namespace QDEngine {
 
+uint32 qdNamedObject::_change_counter = 0;
+uint32 qdNamedObject::_change_epoch = 1;
 
 qdNamedObject::qdNamedObject() : _owner(0),
 	_trigger_reference_count(0),
-	_flags(0) {
+	_flags(0),
+	_change_stamp(0) {
 }
 
 qdNamedObject::qdNamedObject(const qdNamedObject &obj) : qdNamedObjectBase(obj),
 	_owner(obj._owner),
 	_flags(obj._flags),
-	_trigger_reference_count(0) {
+	_trigger_reference_count(0),
+	_change_stamp(0) {
+	touch();
 }
 
 qdNamedObject::~qdNamedObject() {
@@ -49,6 +54,8 @@ qdNamedObject &qdNamedObject::operator = (const qdNamedObject &obj) {
 
 	_flags = obj._flags;
 	_owner = obj._owner;
+
+	touch();
 	return *this;
 }
 
@@ -65,6 +72,7 @@ qdNamedObject *qdNamedObject::owner(qdNamedObjectType tp) const {
 
 bool qdNamedObject::load_data(Common::SeekableReadStream &fh, int saveVersion) {
 	_flags = fh.readSint32LE();
+	touch();
 	return true;
 }
 
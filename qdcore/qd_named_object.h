@@ -89,11 +89,17 @@ public:
 
 	//! Устанавливает флаг.
 	void set_flag(int fl) {
-		_flags |= fl;
+		if ((_flags | fl) != _flags) {
+			_flags |= fl;
+			touch();
+		}
 	}
 	//! Скидывает флаг.
 	void drop_flag(int fl) {
-		_flags &= ~fl;
+		if (_flags & fl) {
+			_flags &= ~fl;
+			touch();
+		}
 	}
 	//! Возвращает true, если установлен флаг fl.
 	bool check_flag(int fl) const {
@@ -102,7 +108,10 @@ public:
 	}
 	//! Очищает флаги.
 	void clear_flags() {
-		_flags = 0;
+		if (_flags) {
+			_flags = 0;
+			touch();
+		}
 	}
 	//! Возвращает значение флагов объекта.
 	int flags() const {
@@ -137,6 +146,38 @@ public:
 
 	Common::String toString() const;
 
+	//! Отмечает, что состояние объекта изменилось.
+	/**
+	Вызывается при изменении флагов и данных объекта, от которых
+	зависят результаты проверки условий, см. qdCondition::check().
+	*/
+	void touch() {
+		if (!++_change_counter)
+			_change_epoch++;
+		_change_stamp = _change_counter;
+	}
+	//! Отметка последнего изменения объекта.
+	uint32 change_stamp() const {
+		return _change_stamp;
+	}
+
+	//! Текущее значение глобального счетчика изменений.
+	static uint32 change_counter() {
+		return _change_counter;
+	}
+	//! Номер эпохи изменений.
+	/**
+	Меняется при переполнении счетчика изменений и при массовых изменениях
+	(загрузка сэйва, смена сцены), когда отметки объектов не отслеживаются.
+	*/
+	static uint32 change_epoch() {
+		return _change_epoch;
+	}
+	//! Начинает новую эпоху изменений, все запомненные отметки становятся недействительными.
+	static void reset_change_epoch() {
+		_change_epoch++;
+	}
+
 private:
 
 	//! Некие свойства объекта.
@@ -147,6 +188,12 @@ private:
 
 	//! Владелец объекта.
 	mutable qdNamedObject *_owner;
+
+	//! Отметка последнего изменения объекта.
+	uint32 _change_stamp;
+
+	static uint32 _change_counter;
+	static uint32 _change_epoch;
 };
 
 } // namespace QDEngine
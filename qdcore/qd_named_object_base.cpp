@@ -24,10 +24,11 @@
 
 namespace QDEngine {
 
-qdNamedObjectBase::qdNamedObjectBase() {
+qdNamedObjectBase::qdNamedObjectBase() : _name_atom(0) {
 }
 
-qdNamedObjectBase::qdNamedObjectBase(const qdNamedObjectBase &obj) : _name(obj._name) {
+qdNamedObjectBase::qdNamedObjectBase(const qdNamedObjectBase &obj) : _name(obj._name),
+	_name_atom(obj._name_atom) {
 }
 
 qdNamedObjectBase::~qdNamedObjectBase() {
@@ -36,8 +37,19 @@ qdNamedObjectBase::~qdNamedObjectBase() {
 qdNamedObjectBase &qdNamedObjectBase::operator = (const qdNamedObjectBase &obj) {
 	if (this == &obj) return *this;
 
-	_name = obj._name;
+	set_name(obj.name());
 
 	return *this;
 }
+
+void qdNamedObjectBase::set_name(const char *p) {
+	if (p) _name = p;
+	else _name.clear();
+
+	qdNameAtom atom = qdNameAtomTable::instance().intern(name());
+	if (atom != _name_atom) {
+		_name_atom = atom;
+		name_changed();
+	}
+}
 } // namespace QDEngine
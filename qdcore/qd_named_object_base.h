@@ -24,6 +24,8 @@
 
 #include "common/str.h"
 
+#include "qdengine/qdcore/qd_name_atom.h"
+
 namespace QDEngine {
 
 //! Базовый поименованный объект.
@@ -42,15 +44,27 @@ public:
 		return NULL;
 	}
 	//! Устанавливает имя объекта.
-	void set_name(const char *p) {
-		if (p) _name = p;
-		else _name.clear();
+	void set_name(const char *p);
+
+	//! Возвращает идентификатор имени объекта.
+	/**
+	Одинаковые идентификаторы - у имен, совпадающих без учета регистра.
+	*/
+	qdNameAtom name_atom() const {
+		return _name_atom;
 	}
 
+protected:
+
+	//! Вызывается при смене идентификатора имени объекта.
+	virtual void name_changed() { }
+
 private:
 
 	//! Имя объекта.
 	Common::String _name;
+	//! Идентификатор имени.
+	qdNameAtom _name_atom;
 };
 
 } // namespace QDEngine
@@ -22,16 +22,24 @@
 #ifndef QDENGINE_QDCORE_QD_OBJECT_LIST_CONTAINER_H
 #define QDENGINE_QDCORE_QD_OBJECT_LIST_CONTAINER_H
 
+#include "common/hash-str.h"
+#include "common/hashmap.h"
 #include "common/str.h"
-#include "common/std/list.h"
+#include "common/std/vector.h"
 
 
 namespace QDEngine {
 
+//! Список объектов с поиском по имени без учета регистра.
+/**
+Объекты хранятся в массиве в порядке добавления, для поиска по имени
+поддерживается индекс, который обновляется при добавлении, удалении и
+переименовании объектов.
+*/
 template <class T>
 class qdObjectListContainer {
 public:
-	typedef Std::list<T *> object_list_t;
+	typedef Std::vector<T *> object_list_t;
 
 	qdObjectListContainer();
 	~qdObjectListContainer();
@@ -57,13 +65,21 @@ public:
 
 private:
 
+	typedef Common::HashMap<Common::String, T *, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> object_index_t;
+
 	object_list_t _object_list;
+	//! Индекс объектов по именам.
+	object_index_t _object_index;
+
+	void index_object(T *p);
+	void unindex_object(T *p);
 };
 
 template <class T>
 bool qdObjectListContainer<T>::add_object(T *p) {
 	if (get_object(p->name())) return false;
 	_object_list.push_back(p);
+	index_object(p);
 
 	return true;
 }
@@ -72,10 +88,9 @@ template <class T>
 const T *qdObjectListContainer<T>::get_object(const char *name) const {
 	if (!name) return NULL;
 
-	for (typename object_list_t::const_iterator it = _object_list.begin(); it != _object_list.end(); ++it) {
-		if (!scumm_stricmp(name, (*it)->name()))
-			return *it;
-	}
+	typename object_index_t::const_iterator it = _object_index.find(name);
+	if (it != _object_index.end())
+		return it->_value;
 
 	return NULL;
 }
@@ -84,10 +99,9 @@ template <class T>
 T *qdObjectListContainer<T>::get_object(const char *name) {
 	if (!name) return NULL;
 
-	for (typename object_list_t::const_iterator it = _object_list.begin(); it != _object_list.end(); ++it) {
-		if (!scumm_stricmp(name, (*it)->name()))
-			return *it;
-	}
+	typename object_index_t::iterator it = _object_index.find(name);
+	if (it != _object_index.end())
+		return it->_value;
 
 	return NULL;
 }
@@ -97,6 +111,7 @@ bool qdObjectListContainer<T>::remove_object(T *p) {
 	for (typename object_list_t::iterator it = _object_list.begin(); it != _object_list.end(); ++it) {
 		if (*it == p) {
 			_object_list.erase(it);
+			unindex_object(p);
 			return true;
 		}
 	}
@@ -114,10 +129,45 @@ bool qdObjectListContainer<T>::remove_object(const char *name) {
 
 template <class T>
 bool qdObjectListContainer<T>::rename_object(T *p, const char *name) {
+	unindex_object(p);
 	p->set_name(name);
+
+	for (typename object_list_t::const_iterator it = _object_list.begin(); it != _object_list.end(); ++it) {
+		if (*it == p) {
+			index_object(p);
+			break;
+		}
+	}
+
 	return true;
 }
 
+template <class T>
+void qdObjectListContainer<T>::index_object(T *p) {
+	// при совпадении имен находится объект, добавленный раньше
+	if (p->name() && !_object_index.contains(p->name()))
+		_object_index[p->name()] = p;
+}
+
+template <class T>
+void qdObjectListContainer<T>::unindex_object(T *p) {
+	if (!p->name()) return;
+
+	typename object_index_t::iterator it = _object_index.find(p->name());
+	if (it == _object_index.end() || it->_value != p)
+		return;
+
+	_object_index.erase(it);
+
+	// объект с таким же именем, если есть, становится доступен по имени
+	for (typename object_list_t::const_iterator jt = _object_list.begin(); jt != _object_list.end(); ++jt) {
+		if (*jt != p && (*jt)->name() && !scumm_stricmp((*jt)->name(), p->name())) {
+			_object_index[(*jt)->name()] = *jt;
+			break;
+		}
+	}
+}
+
 template <class T>
 qdObjectListContainer<T>::qdObjectListContainer() {
 }
@@ -129,6 +179,8 @@ qdObjectListContainer<T>::~qdObjectListContainer() {
 
 template <class T>
 bool qdObjectListContainer<T>::clear() {
+	_object_index.clear();
+
 	for (typename object_list_t::iterator it = _object_list.begin(); it != _object_list.end(); ++it)
 		delete *it;
 
@@ -23,6 +23,7 @@
 #define QDENGINE_QDCORE_QD_OBJECT_MAP_CONTAINER_H
 
 #include "common/system.h"
+#include "common/std/vector.h"
 
 #include "qdengine/qdengine.h"
 
@@ -32,7 +33,7 @@ namespace QDEngine {
 template <class T>
 class qdObjectMapContainer {
 public:
-	typedef Std::list<T *> object_list_t;
+	typedef Std::vector<T *> object_list_t;
 
 	qdObjectMapContainer();
 	~qdObjectMapContainer();
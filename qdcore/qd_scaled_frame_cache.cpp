@@ -0,0 +1,163 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/debug.h"
+
+#include "qdengine/qdengine.h"
+#include "qdengine/qdcore/qd_animation_frame.h"
+#include "qdengine/qdcore/qd_scaled_frame_cache.h"
+
+
+namespace QDEngine {
+
+qdScaledFrameCache qdScaledFrameCache::_instance;
+
+qdScaledFrameCache::qdScaledFrameCache() : qdMemoryCache("scaled"),
+	_scaleStep(0.0f) {
+}
+
+qdScaledFrameCache::~qdScaledFrameCache() {
+	clear();
+}
+
+qdScaledFrameCache::FrameEntry::~FrameEntry() {
+	delete frame;
+}
+
+void qdScaledFrameCache::setScaleStep(float step) {
+	if (step != _scaleStep)
+		clear();
+
+	_scaleStep = step;
+}
+
+const qdAnimationFrame *qdScaledFrameCache::get(const qdAnimationFrame *frame, float &scale) {
+	if (!memoryLimit() || _scaleStep < 0.001f || scale <= 0.0f)
+		return 0;
+
+	if (!frame->data() && !frame->is_compressed())
+		return 0;
+
+	int step = round(log(scale) / log(1.0f + _scaleStep));
+	if (!step)
+		return 0;
+
+	SourceMap::const_iterator it = _sourceMap.find(frame);
+	if (it != _sourceMap.end()) {
+		for (FrameEntry *p = it->_value; p; p = p->sibling) {
+			if (p->step == step) {
+				hit(p);
+				scale /= pow(1.0f + _scaleStep, step);
+				return p->frame;
+			}
+		}
+	}
+
+	miss();
+
+	float coeff = pow(1.0f + _scaleStep, step);
+
+	if (round(float(frame->picture_size_x()) * coeff) < 1 || round(float(frame->picture_size_y()) * coeff) < 1)
+		return 0;
+
+	// qdSprite::scale() масштабирует кадр целиком, до обрезки
+	uint32 estimate = uint32(round(float(frame->size_x()) * coeff)) * uint32(round(float(frame->size_y()) * coeff)) * 4;
+	if (estimate > memoryLimit())
+		return 0;
+
+	qdAnimationFrame *scaled_frame = frame->clone();
+	if (scaled_frame->is_compressed())
+		scaled_frame->uncompress();
+
+	if (!scaled_frame->scale(coeff, coeff)) {
+		delete scaled_frame;
+		return 0;
+	}
+
+	uint32 size = scaled_frame->data_size() + sizeof(qdAnimationFrame) + sizeof(FrameEntry);
+	if (!reserve(size)) {
+		delete scaled_frame;
+		return 0;
+	}
+
+	debugC(3, kDebugGraphics, "qdScaledFrameCache::get(): %d x %d -> %d x %d, step %d",
+	       frame->picture_size_x(), frame->picture_size_y(), scaled_frame->picture_size_x(), scaled_frame->picture_size_y(), step);
+
+	FrameEntry *p = new FrameEntry;
+	p->source = frame;
+	p->step = step;
+	p->frame = scaled_frame;
+	p->size = size;
+
+	SourceMap::iterator is = _sourceMap.find(frame);
+	if (is != _sourceMap.end()) {
+		p->sibling = is->_value;
+		is->_value = p;
+	} else
+		_sourceMap[frame] = p;
+
+	insert(p);
+
+	scale /= coeff;
+	return scaled_frame;
+}
+
+void qdScaledFrameCache::release(const qdAnimationFrame *frame) {
+	if (!entryCount())
+		return;
+
+	SourceMap::iterator it = _sourceMap.find(frame);
+	if (it == _sourceMap.end())
+		return;
+
+	// remove() снимает кадр с начала цепочки
+	for (FrameEntry *p = it->_value; p; ) {
+		FrameEntry *next = p->sibling;
+		remove(p);
+		p = next;
+	}
+}
+
+void qdScaledFrameCache::detach(Entry *entry) {
+	FrameEntry *p = static_cast<FrameEntry *>(entry);
+
+	SourceMap::iterator it = _sourceMap.find(p->source);
+	assert(it != _sourceMap.end());
+
+	if (it->_value == p) {
+		if (p->sibling)
+			it->_value = p->sibling;
+		else
+			_sourceMap.erase(it);
+	} else {
+		FrameEntry *sp = it->_value;
+		while (sp->sibling != p)
+			sp = sp->sibling;
+		sp->sibling = p->sibling;
+	}
+}
+
+void qdScaledFrameCache::detachAll() {
+	_sourceMap.clear(true);
+}
+
+} // namespace QDEngine
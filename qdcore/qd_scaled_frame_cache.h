@@ -0,0 +1,93 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef QDENGINE_QDCORE_QD_SCALED_FRAME_CACHE_H
+#define QDENGINE_QDCORE_QD_SCALED_FRAME_CACHE_H
+
+#include "common/hashmap.h"
+
+#include "qdengine/qdcore/qd_memory_cache.h"
+
+namespace QDEngine {
+
+class qdAnimationFrame;
+
+//! Кэш отмасштабированных кадров анимации.
+/**
+Масштаб квантуется с шагом scaleStep() (по логарифмической шкале),
+кадр для каждого шага один раз строится через C2PassScale и
+дальше рисуется без масштабирования.
+Общий для всех анимаций, ограничен по памяти.
+*/
+class qdScaledFrameCache : public qdMemoryCache {
+public:
+	qdScaledFrameCache();
+	~qdScaledFrameCache();
+
+	static qdScaledFrameCache &instance() {
+		return _instance;
+	}
+
+	/// Шаг квантования масштаба (0.02 - 2%), 0 - кэш выключен.
+	float scaleStep() const {
+		return _scaleStep;
+	}
+	void setScaleStep(float step);
+
+	/// Возвращает отмасштабированный кадр или 0, если кадр в кэш не попадает.
+	/**
+	scale заменяется на масштаб, с которым надо рисовать возвращённый кадр
+	(отличается от 1 не больше чем на половину шага квантования).
+	*/
+	const qdAnimationFrame *get(const qdAnimationFrame *frame, float &scale);
+
+	/// Удаляет из кэша все кадры, построенные из frame.
+	void release(const qdAnimationFrame *frame);
+
+private:
+	struct FrameEntry : public Entry {
+		FrameEntry() : source(0), step(0), frame(0), sibling(0) { }
+		~FrameEntry();
+
+		const qdAnimationFrame *source;
+		int step;
+		qdAnimationFrame *frame;
+
+		/// Следующий кадр из того же исходного.
+		FrameEntry *sibling;
+	};
+
+	typedef Common::HashMap<const qdAnimationFrame *, FrameEntry *, PointerHash> SourceMap;
+
+	float _scaleStep;
+
+	SourceMap _sourceMap;
+
+	void detach(Entry *p);
+	void detachAll();
+
+	static qdScaledFrameCache _instance;
+};
+
+} // namespace QDEngine
+
+#endif // QDENGINE_QDCORE_QD_SCALED_FRAME_CACHE_H
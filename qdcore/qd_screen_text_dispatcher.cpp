@@ -88,6 +88,13 @@ void qdScreenTextDispatcher::pre_redraw() const {
 void qdScreenTextDispatcher::post_redraw() {
 }
 
+grScreenRegion qdScreenTextDispatcher::screen_region() const {
+	grScreenRegion reg = grScreenRegion::EMPTY;
+	for (text_sets_container_t::const_iterator it = _text_sets.begin(); it != _text_sets.end(); ++it)
+		reg += it->screen_region();
+	return reg;
+}
+
 bool qdScreenTextDispatcher::save_script(Common::WriteStream &fh, int indent) const {
 	for (auto &it : _text_sets) {
 		it.save_script(fh, indent);
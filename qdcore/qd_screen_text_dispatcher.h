@@ -54,6 +54,8 @@ public:
 	//! Отрисовка текстов.
 	void redraw() const;
 	void pre_redraw() const;
+	//! Область экрана, занимаемая всеми текстами.
+	grScreenRegion screen_region() const;
 	void post_redraw();
 
 	bool save_script(Common::WriteStream &fh, int indent = 0) const;
@@ -107,6 +107,16 @@ qdGameConfig::qdGameConfig() {
 	_locale = "Russian";
 
 	_minigame_read_only_ini = false;
+
+	_native_rle = true;
+	_tile_cache_size = 4096;
+	_scaled_frame_cache_size = 8192;
+	_scaled_frame_step = 2;
+	_hit_mask_cache_size = 1024;
+	_contour_cache_size = 512;
+	_changed_regions_mode = 1;
+	_scroll_redraw = true;
+	_fade_cached_frame = false;
 }
 
 void qdGameConfig::set_pixel_format(int pf) {
@@ -184,6 +194,33 @@ void qdGameConfig::load() {
 	p = getIniKey(_ini_name, "graphics", "driver");
 	if (strlen(p)) _driver_id = atoi(p);
 
+	p = getIniKey(_ini_name, "graphics", "native_rle");
+	if (strlen(p)) _native_rle = (atoi(p) > 0);
+
+	p = getIniKey(_ini_name, "graphics", "tile_cache_size");
+	if (strlen(p)) _tile_cache_size = atoi(p);
+
+	p = getIniKey(_ini_name, "graphics", "scaled_frame_cache_size");
+	if (strlen(p)) _scaled_frame_cache_size = atoi(p);
+
+	p = getIniKey(_ini_name, "graphics", "scaled_frame_step");
+	if (strlen(p)) _scaled_frame_step = atoi(p);
+
+	p = getIniKey(_ini_name, "graphics", "hit_mask_cache_size");
+	if (strlen(p)) _hit_mask_cache_size = atoi(p);
+
+	p = getIniKey(_ini_name, "graphics", "contour_cache_size");
+	if (strlen(p)) _contour_cache_size = atoi(p);
+
+	p = getIniKey(_ini_name, "graphics", "changed_regions_mode");
+	if (strlen(p)) _changed_regions_mode = atoi(p);
+
+	p = getIniKey(_ini_name, "graphics", "scroll_redraw");
+	if (strlen(p)) _scroll_redraw = (atoi(p) > 0);
+
+	p = getIniKey(_ini_name, "graphics", "fade_cached_frame");
+	if (strlen(p)) _fade_cached_frame = atoi(p) != 0;
+
 	p = getIniKey(_ini_name, "game", "logic_period");
 	if (strlen(p)) _logic_period = atoi(p);
 
@@ -182,6 +182,78 @@ public:
 		return _minigame_read_only_ini;
 	}
 
+	//! Переводить ли RLE-спрайты при загрузке в формат экрана (RGB565).
+	bool native_rle() const {
+		return _native_rle;
+	}
+	void toggle_native_rle(bool state) {
+		_native_rle = state;
+	}
+
+	//! Размер кэша распакованных тайлов в килобайтах.
+	int tile_cache_size() const {
+		return _tile_cache_size;
+	}
+	void set_tile_cache_size(int size) {
+		_tile_cache_size = size;
+	}
+
+	//! Размер кэша отмасштабированных кадров анимации в килобайтах.
+	int scaled_frame_cache_size() const {
+		return _scaled_frame_cache_size;
+	}
+	void set_scaled_frame_cache_size(int size) {
+		_scaled_frame_cache_size = size;
+	}
+
+	//! Шаг квантования масштаба для кэша кадров в процентах, 0 - кэш не используется.
+	int scaled_frame_step() const {
+		return _scaled_frame_step;
+	}
+	void set_scaled_frame_step(int step) {
+		_scaled_frame_step = step;
+	}
+
+	//! Размер кэша масок для проверки попадания мышью в килобайтах.
+	int hit_mask_cache_size() const {
+		return _hit_mask_cache_size;
+	}
+	void set_hit_mask_cache_size(int size) {
+		_hit_mask_cache_size = size;
+	}
+
+	//! Размер кэша контуров подсвеченных объектов в килобайтах.
+	int contour_cache_size() const {
+		return _contour_cache_size;
+	}
+	void set_contour_cache_size(int size) {
+		_contour_cache_size = size;
+	}
+
+	//! Способ построения областей перерисовки, см. grDispatcher::ChangedRegionsMode.
+	int changed_regions_mode() const {
+		return _changed_regions_mode;
+	}
+	void set_changed_regions_mode(int mode) {
+		_changed_regions_mode = mode;
+	}
+
+	//! Прокручивать изображение при движении камеры вместо полной перерисовки.
+	bool scroll_redraw() const {
+		return _scroll_redraw;
+	}
+	void toggle_scroll_redraw(bool state) {
+		_scroll_redraw = state;
+	}
+
+	//! Затемнять при смене сцены запомненный кадр, а не перерисовывать сцену каждый кадр.
+	bool fade_cached_frame() const {
+		return _fade_cached_frame;
+	}
+	void toggle_fade_cached_frame(bool state) {
+		_fade_cached_frame = state;
+	}
+
 private:
 
 	int _bits_per_pixel;
@@ -219,6 +291,16 @@ private:
 
 	bool _minigame_read_only_ini;
 
+	bool _native_rle;
+	int _tile_cache_size;
+	int _scaled_frame_cache_size;
+	int _scaled_frame_step;
+	int _hit_mask_cache_size;
+	int _contour_cache_size;
+	int _changed_regions_mode;
+	bool _scroll_redraw;
+	bool _fade_cached_frame;
+
 	static qdGameConfig _config;
 	static const char *const _ini_name;
 };
@@ -117,7 +117,7 @@ private:
 	wavSound _sound;
 };
 
-typedef Std::list<qdSound *> qdSoundList;
+typedef Std::vector<qdSound *> qdSoundList;
 
 } // namespace QDEngine
 
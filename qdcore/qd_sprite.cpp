@@ -33,6 +33,8 @@
 #include "qdengine/qdcore/qd_setup.h"
 #include "qdengine/qdcore/qd_sprite.h"
 #include "qdengine/qdcore/qd_file_manager.h"
+#include "qdengine/qdcore/qd_hit_mask_cache.h"
+#include "qdengine/qdcore/qd_sprite_contour_cache.h"
 #include "qdengine/qdcore/util/2PassScale.h"
 #include "qdengine/qdcore/util/Filters.h"
 
@@ -136,6 +138,8 @@ qdSprite::~qdSprite() {
 qdSprite &qdSprite::operator = (const qdSprite &spr) {
 	if (this == &spr) return *this;
 
+	release_caches();
+
 	_format = spr._format;
 	_flags = spr._flags;
 	_size = spr._size;
@@ -178,6 +182,8 @@ qdSprite &qdSprite::operator = (const qdSprite &spr) {
 }
 
 void qdSprite::free() {
+	release_caches();
+
 	delete [] _data;
 	delete _rle_data;
 
@@ -835,6 +841,12 @@ void qdSprite::draw_mask_rot(int x, int y, int z, float angle, uint32 mask_color
 		grDispatcher::instance()->putSprMask_rle_rot(Vect2i(xx, yy), _picture_size, _rle_data, check_flag(ALPHA_FLAG), mask_color, mask_alpha, mode, angle, scale);
 }
 
+static void draw_contour_spans(int x, int y, const qdSpriteContourCache::SpanList &spans, uint32 color) {
+	grDispatcher *dp = grDispatcher::instance();
+	for (qdSpriteContourCache::SpanList::const_iterator it = spans.begin(); it != spans.end(); ++it)
+		dp->erase(x + it->x, y + it->y, it->length, 1, color);
+}
+
 void qdSprite::draw_contour(int x, int y, uint32 color, int mode) const {
 	int xx = x - size_x() / 2;
 	int yy = y - size_y() / 2;
@@ -849,6 +861,11 @@ void qdSprite::draw_contour(int x, int y, uint32 color, int mode) const {
 	else
 		yy += _picture_offset.y;
 
+	if (const qdSpriteContourCache::SpanList *spans = qdSpriteContourCache::instance().get(this, _picture_size.x, _picture_size.y, mode)) {
+		draw_contour_spans(xx, yy, *spans, color);
+		return;
+	}
+
 	if (is_compressed()) {
 		grDispatcher::instance()->drawSprContour(xx, yy, _picture_size.x, _picture_size.y, _rle_data, color, mode, check_flag(ALPHA_FLAG));
 	} else {
@@ -874,6 +891,11 @@ void qdSprite::draw_contour(int x, int y, uint32 color, float scale, int mode) c
 	else
 		yy += round(float(_picture_offset.y) * scale);
 
+	if (const qdSpriteContourCache::SpanList *spans = qdSpriteContourCache::instance().get(this, round(float(_picture_size.x) * scale), round(float(_picture_size.y) * scale), mode)) {
+		draw_contour_spans(xx, yy, *spans, color);
+		return;
+	}
+
 	if (!is_compressed()) {
 		if (check_flag(ALPHA_FLAG))
 			grDispatcher::instance()->drawSprContour_a(xx, yy, _picture_size.x, _picture_size.y, _data, color, mode, scale);
@@ -893,6 +915,10 @@ bool qdSprite::hit(int x, int y) const {
 		x -= _picture_offset.x;
 		y -= _picture_offset.y;
 
+		qdHitMask mask;
+		if (qdHitMaskCache::instance().get(this, mask))
+			return mask.test(x, y);
+
 		if (!is_compressed()) {
 			if (!_data) return false;
 
@@ -938,6 +964,81 @@ bool qdSprite::hit(int x, int y) const {
 	return false;
 }
 
+void qdSprite::release_caches() const {
+	qdHitMaskCache::instance().release(this);
+	qdSpriteContourCache::instance().release(this);
+}
+
+bool qdSprite::build_hit_mask(uint32 *mask, int stride, int alpha_threshold) const {
+	const int sx = _picture_size.x;
+	const int sy = _picture_size.y;
+
+	memset(mask, 0, stride * sy * sizeof(uint32));
+
+	if (!is_compressed()) {
+		if (!_data) return false;
+
+		for (int y = 0; y < sy; y++) {
+			uint32 *mask_line = mask + y * stride;
+
+			for (int x = 0; x < sx; x++) {
+				int idx = x + y * sx;
+				bool opaque = false;
+
+				switch (_format) {
+				case GR_RGB565:
+				case GR_ARGB1555:
+					if (check_flag(ALPHA_FLAG))
+						opaque = reinterpret_cast<const uint16 *>(_data)[idx * 2 + 1] < alpha_threshold;
+					else
+						opaque = reinterpret_cast<const uint16 *>(_data)[idx] != 0;
+					break;
+				case GR_RGB888:
+					opaque = _data[idx * 3] || _data[idx * 3 + 1] || _data[idx * 3 + 2];
+					break;
+				case GR_ARGB8888:
+					opaque = _data[idx * 4 + 3] < alpha_threshold;
+					break;
+				default:
+					return false;
+				}
+
+				if (opaque)
+					mask_line[x >> 5] |= 1U << (x & 31);
+			}
+		}
+	} else {
+		bool alpha = check_flag(ALPHA_FLAG);
+		bool alpha16 = _format == GR_RGB565 || _format == GR_ARGB1555;
+
+		for (int y = 0; y < sy; y++) {
+			uint32 *mask_line = mask + y * stride;
+
+			_rle_data->decode_line(y);
+			const uint32 *line = reinterpret_cast<const uint32 *>(rleBuffer::get_buffer(0));
+
+			for (int x = 0; x < sx; x++) {
+				uint32 pixel = line[x];
+				bool opaque;
+
+				// то же правило, что и в hit() для упакованных данных
+				if (alpha) {
+					if (alpha16)
+						opaque = reinterpret_cast<const uint16 *>(&pixel)[1] < alpha_threshold;
+					else
+						opaque = reinterpret_cast<const byte *>(&pixel)[3] < alpha_threshold;
+				} else
+					opaque = pixel != 0;
+
+				if (opaque)
+					mask_line[x >> 5] |= 1U << (x & 31);
+			}
+		}
+	}
+
+	return true;
+}
+
 bool qdSprite::hit(int x, int y, float scale) const {
 	x = round(float(x) / scale);
 	y = round(float(y) / scale);
@@ -952,6 +1053,8 @@ bool qdSprite::put_pixel(int x, int y, byte r, byte g, byte b) {
 	if ((x < 0) || (x >= _size.x) || (y < 0) || (y >= _size.y))
 		return false;
 
+	release_caches();
+
 	int bytes_per_pix;
 	uint16 word;
 
@@ -1103,6 +1206,10 @@ void qdSprite::qda_load(Common::SeekableReadStream *fh, int version) {
 	} else {
 		_rle_data = new rleBuffer;
 		_rle_data->load(fh);
+
+		// данные convert_native() хранятся в RGB565
+		if (qdGameConfig::get_config().native_rle() && grDispatcher::instance()->screen_format() == GR_RGB565 && (_format == GR_RGB888 || _format == GR_ARGB8888))
+			_rle_data->convert_native(check_flag(ALPHA_FLAG));
 	}
 }
 
@@ -1118,6 +1225,8 @@ bool qdSprite::crop(int left, int top, int right, int bottom, bool store_offsets
 
 	if (sx == _picture_size.x && sy == _picture_size.y) return true;
 
+	release_caches();
+
 	int psz = 1;
 	switch (_format) {
 	case GR_RGB565:
@@ -1163,6 +1272,8 @@ bool qdSprite::undo_crop() {
 
 	if (_picture_size == _size) return false;
 
+	release_caches();
+
 	int psx = 1;
 	if (_format == GR_RGB565 || _format == GR_ARGB1555)
 		psx = (check_flag(ALPHA_FLAG)) ? 4 : 2;
@@ -1358,6 +1469,8 @@ bool qdSprite::scale(float coeff_x, float coeff_y) {
 	static scl::C2PassScale<scl::CBilinearFilter> scale_engine;
 	static Std::vector<byte> temp_buffer(300 * 400 * 4, 0);
 
+	release_caches();
+
 	bool compress_flag = false;
 
 	if (is_compressed()) {
@@ -126,6 +126,14 @@ public:
 	bool hit(int x, int y) const;
 	bool hit(int x, int y, float scale) const;
 
+	//! Заполняет маску непрозрачности картинки спрайта, один бит на пиксел.
+	/**
+	stride - длина строки маски в 32-битных словах.
+	Пикселы считаются непрозрачными по тем же правилам, что и в hit(),
+	для спрайтов с альфа-каналом - если прозрачность меньше alpha_threshold.
+	*/
+	bool build_hit_mask(uint32 *mask, int stride, int alpha_threshold = 240) const;
+
 	bool put_pixel(int x, int y, byte r, byte g, byte b);
 
 	bool crop();
@@ -213,6 +221,9 @@ private:
 
 	Common::String _file;
 
+	//! Удаляет построенные по данным спрайта маски и контуры.
+	void release_caches() const;
+
 	friend bool operator == (const qdSprite &sp1, const qdSprite &sp2);
 };
 
@@ -0,0 +1,212 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/debug.h"
+
+#include "qdengine/qdengine.h"
+#include "qdengine/system/graphics/gr_dispatcher.h"
+#include "qdengine/qdcore/qd_sprite.h"
+#include "qdengine/qdcore/qd_sprite_contour_cache.h"
+
+
+namespace QDEngine {
+
+qdSpriteContourCache qdSpriteContourCache::_instance;
+
+qdSpriteContourCache::qdSpriteContourCache() : qdMemoryCache("contours") {
+}
+
+qdSpriteContourCache::~qdSpriteContourCache() {
+	clear();
+}
+
+const qdSpriteContourCache::SpanList *qdSpriteContourCache::get(const qdSprite *sprite, int sx, int sy, int mode) {
+	if (!memoryLimit() || sx <= 0 || sy <= 0 || sx > 0x7FFF || sy > 0x7FFF)
+		return 0;
+
+	mode &= GR_FLIP_HORIZONTAL | GR_FLIP_VERTICAL;
+
+	SpriteMap::const_iterator it = _spriteMap.find(sprite);
+	if (it != _spriteMap.end()) {
+		for (ContourEntry *p = it->_value; p; p = p->sibling) {
+			if (p->sx == sx && p->sy == sy && p->mode == mode) {
+				hit(p);
+				return &p->spans;
+			}
+		}
+	}
+
+	miss();
+
+	ContourEntry *p = new ContourEntry;
+	if (!build(sprite, sx, sy, mode, p->spans)) {
+		delete p;
+		return 0;
+	}
+
+	uint32 size = p->spans.size() * sizeof(Span) + sizeof(ContourEntry);
+	if (!reserve(size)) {
+		delete p;
+		return 0;
+	}
+
+	debugC(3, kDebugGraphics, "qdSpriteContourCache::get(): %d x %d -> %d x %d, %d spans",
+	       sprite->picture_size_x(), sprite->picture_size_y(), sx, sy, (int)p->spans.size());
+
+	p->sprite = sprite;
+	p->sx = sx;
+	p->sy = sy;
+	p->mode = mode;
+	p->size = size;
+
+	SpriteMap::iterator is = _spriteMap.find(sprite);
+	if (is != _spriteMap.end()) {
+		p->sibling = is->_value;
+		is->_value = p;
+	} else
+		_spriteMap[sprite] = p;
+
+	insert(p);
+
+	return &p->spans;
+}
+
+bool qdSpriteContourCache::build(const qdSprite *sprite, int sx, int sy, int mode, SpanList &spans) {
+	if (!sprite->data() && !sprite->is_compressed())
+		return false;
+
+	const int src_sx = sprite->picture_size_x();
+	const int src_sy = sprite->picture_size_y();
+	if (src_sx <= 0 || src_sy <= 0)
+		return false;
+
+	const int stride = (src_sx + 31) >> 5;
+	_mask.resize(stride * src_sy);
+	if (!sprite->build_hit_mask(&_mask[0], stride, CONTOUR_ALPHA_THRESHOLD))
+		return false;
+
+	// выборка из исходной картинки такая же, как в масштабирующих функциях вывода
+	Std::vector<int> columns(sx);
+	int dx = (src_sx << 16) / sx;
+	int fx = (1 << 15);
+	for (int j = 0; j < sx; j++) {
+		columns[j] = MIN(fx >> 16, src_sx - 1);
+		fx += dx;
+	}
+
+	Std::vector<int> rows(sy);
+	int dy = (src_sy << 16) / sy;
+	int fy = (1 << 15);
+	for (int i = 0; i < sy; i++) {
+		rows[i] = MIN(fy >> 16, src_sy - 1);
+		fy += dy;
+	}
+
+	// три соседние строки выборки, с прозрачными пикселами по краям
+	Std::vector<byte> lines((sx + 2) * 3, 0);
+	byte *line_prev = &lines[0];
+	byte *line = line_prev + sx + 2;
+	byte *line_next = line + sx + 2;
+
+	const bool flip_x = (mode & GR_FLIP_HORIZONTAL) != 0;
+	const bool flip_y = (mode & GR_FLIP_VERTICAL) != 0;
+
+	for (int i = -1; i < sy; i++) {
+		byte *tmp = line_prev;
+		line_prev = line;
+		line = line_next;
+		line_next = tmp;
+
+		if (i + 1 < sy) {
+			const uint32 *mask_line = &_mask[rows[flip_y ? sy - 2 - i : i + 1] * stride];
+			for (int j = 0; j < sx; j++) {
+				int col = columns[flip_x ? sx - 1 - j : j];
+				line_next[j + 1] = (mask_line[col >> 5] >> (col & 31)) & 1;
+			}
+		} else
+			memset(line_next, 0, sx + 2);
+
+		if (i < 0)
+			continue;
+
+		int start = -1;
+		for (int j = 1; j <= sx + 1; j++) {
+			bool edge = j <= sx && line[j] && (!line[j - 1] || !line[j + 1] || !line_prev[j] || !line_next[j]);
+
+			if (edge) {
+				if (start < 0)
+					start = j;
+			} else if (start >= 0) {
+				Span span;
+				span.x = start - 1;
+				span.y = i;
+				span.length = j - start;
+				spans.push_back(span);
+
+				start = -1;
+			}
+		}
+	}
+
+	return true;
+}
+
+void qdSpriteContourCache::release(const qdSprite *sprite) {
+	if (!entryCount())
+		return;
+
+	SpriteMap::iterator it = _spriteMap.find(sprite);
+	if (it == _spriteMap.end())
+		return;
+
+	// remove() снимает контур с начала цепочки
+	for (ContourEntry *p = it->_value; p; ) {
+		ContourEntry *next = p->sibling;
+		remove(p);
+		p = next;
+	}
+}
+
+void qdSpriteContourCache::detach(Entry *entry) {
+	ContourEntry *p = static_cast<ContourEntry *>(entry);
+
+	SpriteMap::iterator it = _spriteMap.find(p->sprite);
+	assert(it != _spriteMap.end());
+
+	if (it->_value == p) {
+		if (p->sibling)
+			it->_value = p->sibling;
+		else
+			_spriteMap.erase(it);
+	} else {
+		ContourEntry *sp = it->_value;
+		while (sp->sibling != p)
+			sp = sp->sibling;
+		sp->sibling = p->sibling;
+	}
+}
+
+void qdSpriteContourCache::detachAll() {
+	_spriteMap.clear(true);
+}
+
+} // namespace QDEngine
@@ -0,0 +1,107 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef QDENGINE_QDCORE_QD_SPRITE_CONTOUR_CACHE_H
+#define QDENGINE_QDCORE_QD_SPRITE_CONTOUR_CACHE_H
+
+#include "common/hashmap.h"
+#include "common/std/vector.h"
+
+#include "qdengine/qdcore/qd_memory_cache.h"
+
+namespace QDEngine {
+
+class qdSprite;
+
+//! Кэш контуров спрайтов для подсветки объектов.
+/**
+Контур - непрозрачные пикселы картинки, у которых хотя бы один
+из четырёх соседей прозрачный или лежит за краем картинки.
+Строится один раз для каждого сочетания спрайта, размера на экране
+и отражений и хранится списком горизонтальных отрезков,
+так что вывод контура стоит как вывод нескольких линий.
+Общий для всех спрайтов, ограничен по памяти.
+*/
+class qdSpriteContourCache : public qdMemoryCache {
+public:
+	qdSpriteContourCache();
+	~qdSpriteContourCache();
+
+	static qdSpriteContourCache &instance() {
+		return _instance;
+	}
+
+	/// Горизонтальный отрезок контура, координаты от левого верхнего угла картинки.
+	struct Span {
+		int16 x;
+		int16 y;
+		int16 length;
+	};
+
+	typedef Std::vector<Span> SpanList;
+
+	/// Возвращает контур картинки спрайта, выведенной с размером sx x sy, или 0.
+	/**
+	В mode учитываются только отражения (GR_FLIP_HORIZONTAL, GR_FLIP_VERTICAL).
+	*/
+	const SpanList *get(const qdSprite *sprite, int sx, int sy, int mode);
+
+	/// Удаляет из кэша все контуры спрайта.
+	void release(const qdSprite *sprite);
+
+private:
+	enum {
+		/// пикселы с меньшей прозрачностью входят в контур, как в grDispatcher::drawSprContour_a()
+		CONTOUR_ALPHA_THRESHOLD = 200
+	};
+
+	struct ContourEntry : public Entry {
+		ContourEntry() : sprite(0), sx(0), sy(0), mode(0), sibling(0) { }
+
+		const qdSprite *sprite;
+		int sx;
+		int sy;
+		int mode;
+		SpanList spans;
+
+		/// Следующий контур того же спрайта.
+		ContourEntry *sibling;
+	};
+
+	typedef Common::HashMap<const qdSprite *, ContourEntry *, PointerHash> SpriteMap;
+
+	SpriteMap _spriteMap;
+
+	/// Маска непрозрачности исходной картинки, используется при построении контура.
+	Std::vector<uint32> _mask;
+
+	bool build(const qdSprite *sprite, int sx, int sy, int mode, SpanList &spans);
+
+	void detach(Entry *p);
+	void detachAll();
+
+	static qdSpriteContourCache _instance;
+};
+
+} // namespace QDEngine
+
+#endif // QDENGINE_QDCORE_QD_SPRITE_CONTOUR_CACHE_H
@@ -45,6 +45,7 @@ qdTriggerChain::~qdTriggerChain() {
 bool qdTriggerChain::reindex_elements() {
 	int id = 0;
 	for (auto &it : _elements) {
+		it->set_chain(this, id);
 		it->set_id(id++);
 	}
 
@@ -92,6 +93,17 @@ bool qdTriggerChain::remove_element(qdTriggerElementPtr p, bool free_mem, bool r
 				}
 			}
 
+			if ((*it)->is_in_active_list()) {
+				for (qdTriggerElementList::iterator ita = _active_elements.begin(); ita != _active_elements.end(); ++ita) {
+					if (*ita == p) {
+						_active_elements.erase(ita);
+						break;
+					}
+				}
+				(*it)->toggle_active_list(false);
+			}
+			(*it)->set_chain(NULL, 0);
+
 			if (free_mem)
 				delete *it;
 
@@ -168,6 +180,7 @@ bool qdTriggerChain::load_script(const xml::tag *p) {
 			break;
 		case QDSCR_TRIGGER_ELEMENT:
 			el = qdTriggerElementPtr(new qdTriggerElement);
+			el->set_chain(this, _elements.size());
 			el->load_script(&*it);
 			_elements.push_back(el);
 			break;
@@ -233,10 +246,67 @@ bool qdTriggerChain::save_script(Common::WriteStream &fh, int indent) const {
 }
 
 void qdTriggerChain::quant(float dt) {
-	root_element()->quant(dt);
+	if (root_element()->active_child_links())
+		root_element()->quant(dt);
+
+	// Элементы, добавленные в список во время обхода, обсчитываются в этом же кванте,
+	// только если стоят в _elements после текущего - как при обходе всего списка.
+	int last_index = -1;
+	for (uint i = 0; i < _active_elements.size(); i++) {
+		qdTriggerElementPtr p = _active_elements[i];
+		if (p->chain_index() <= last_index)
+			continue;
+
+		last_index = p->chain_index();
+
+		if (p->active_child_links())
+			p->quant(dt);
+	}
+
+	uint count = 0;
+	for (uint i = 0; i < _active_elements.size(); i++) {
+		if (_active_elements[i]->active_child_links())
+			_active_elements[count++] = _active_elements[i];
+		else
+			_active_elements[i]->toggle_active_list(false);
+	}
+	_active_elements.resize(count);
+}
+
+void qdTriggerChain::add_active_element(qdTriggerElementPtr p) {
+	if (p == root_element() || p->is_in_active_list())
+		return;
+
+	int lo = 0;
+	int hi = _active_elements.size();
+	while (lo < hi) {
+		int mid = (lo + hi) / 2;
+		if (_active_elements[mid]->chain_index() < p->chain_index())
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	_active_elements.insert(_active_elements.begin() + lo, p);
+	p->toggle_active_list(true);
+}
+
+int qdTriggerChain::active_elements_count() const {
+	int count = root_element()->active_child_links() ? 1 : 0;
+	for (auto &it : _active_elements) {
+		if (it->active_child_links())
+			count++;
+	}
+
+	return count;
+}
+
+int qdTriggerChain::active_links_count() const {
+	int count = root_element()->active_child_links();
+	for (auto &it : _active_elements)
+		count += it->active_child_links();
 
-	for (auto &it : _elements)
-		it->quant(dt);
+	return count;
 }
 
 bool qdTriggerChain::init_debug_check() {
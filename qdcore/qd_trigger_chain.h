@@ -91,11 +91,27 @@ public:
 	bool deactivate_object_triggers(const qdNamedObject *p);
 
 	qdTriggerElementPtr search_element(int id);
+
+	//! Добавляет элемент в список элементов с включенными исходящими связями.
+	void add_active_element(qdTriggerElementPtr p);
+
+	//! Возвращает количество элементов с включенными исходящими связями.
+	int active_elements_count() const;
+	//! Возвращает количество включенных связей.
+	int active_links_count() const;
+
 private:
 
 	qdTriggerElement _root;
 	qdTriggerElementList _elements;
 
+	//! Элементы с включенными исходящими связями, упорядоченные как в _elements.
+	/**
+	Обсчитываются в quant() вместо полного списка элементов. Элементы, у
+	которых связи выключились, удаляются из списка в конце кванта.
+	*/
+	qdTriggerElementList _active_elements;
+
 	bool reindex_elements();
 };
 
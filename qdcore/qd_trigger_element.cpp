@@ -44,6 +44,7 @@ namespace QDEngine {
 
 qdTriggerLink::qdTriggerLink(qdTriggerElementPtr p, int tp)
 	: _element(p),
+	  _owner(NULL),
 	  _element_ID(qdTriggerElement::INVALID_ID),
 	  _type(tp),
 	  _auto_restart(false) {
@@ -54,6 +55,7 @@ qdTriggerLink::qdTriggerLink(qdTriggerElementPtr p, int tp)
 }
 
 qdTriggerLink::qdTriggerLink() : _element(NULL),
+	_owner(NULL),
 	_element_ID(qdTriggerElement::INVALID_ID),
 	_type(0),
 	_auto_restart(false) {
@@ -106,13 +108,21 @@ bool qdTriggerLink::save_script(Common::WriteStream &fh, int indent) const {
 qdTriggerElement::qdTriggerElement() : _object(NULL),
 	_ID(0),
 	_is_active(false),
-	_status(TRIGGER_EL_INACTIVE) {
+	_status(TRIGGER_EL_INACTIVE),
+	_active_child_links(0),
+	_chain(NULL),
+	_chain_index(0),
+	_is_in_active_list(false) {
 }
 
 qdTriggerElement::qdTriggerElement(qdNamedObject *p) : _object(p),
 	_ID(0),
 	_is_active(false),
-	_status(TRIGGER_EL_INACTIVE) {
+	_status(TRIGGER_EL_INACTIVE),
+	_active_child_links(0),
+	_chain(NULL),
+	_chain_index(0),
+	_is_in_active_list(false) {
 	p->add_trigger_reference();
 }
 
@@ -207,6 +217,7 @@ bool qdTriggerElement::add_parent(qdTriggerElementPtr p, int link_type) {
 bool qdTriggerElement::add_child(qdTriggerElementPtr p, int link_type, bool auto_restart) {
 	if (p == this || is_child(p)) return false;
 	_children.push_back(qdTriggerLink(p, link_type));
+	_children.back().set_owner(this);
 	if (auto_restart)
 		_children.back().toggle_auto_restart(true);
 
@@ -226,6 +237,7 @@ bool qdTriggerElement::remove_parent(qdTriggerElementPtr p) {
 bool qdTriggerElement::remove_child(qdTriggerElementPtr p) {
 	for (auto it = _children.begin(); it != _children.end(); it++) {
 		if ((*it).element() == p) {
+			it->set_status(qdTriggerLink::LINK_INACTIVE);
 			_children.erase(it);
 			return true;
 		}
@@ -284,6 +296,11 @@ bool qdTriggerElement::load_links_script(const xml::tag *p, bool load_parents) {
 		}
 	}
 
+	if (!load_parents) {
+		for (auto &it : _children)
+			it.set_owner(this);
+	}
+
 	return true;
 }
 
@@ -708,6 +725,13 @@ bool qdTriggerElement::save_data(Common::WriteStream &fh) const {
 	return true;
 }
 
+void qdTriggerLink::set_status(LinkStatus st) {
+	if (_owner && _status != st)
+		_owner->child_link_status_changed(_status, st);
+
+	_status = st;
+}
+
 void qdTriggerLink::activate() {
 	set_status(LINK_ACTIVE);
 
@@ -775,6 +799,16 @@ void qdTriggerElement::set_status(ElementStatus st) {
 	_status = st;
 }
 
+void qdTriggerElement::child_link_status_changed(qdTriggerLink::LinkStatus old_status, qdTriggerLink::LinkStatus new_status) {
+	if (old_status == qdTriggerLink::LINK_ACTIVE)
+		_active_child_links--;
+
+	if (new_status == qdTriggerLink::LINK_ACTIVE) {
+		if (!_active_child_links++ && _chain)
+			_chain->add_active_element(this);
+	}
+}
+
 void qdTriggerElement::reset() {
 	for (qdTriggerLinkList::iterator it = _parents.begin(); it != _parents.end(); ++it)
 		it->set_status(qdTriggerLink::LINK_INACTIVE);
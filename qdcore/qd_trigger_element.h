@@ -69,9 +69,7 @@ public:
 		return _status;
 	}
 	//! Устанавливает состояние связи.
-	void set_status(LinkStatus st) {
-		_status = st;
-	}
+	void set_status(LinkStatus st);
 
 	//! Возвращает тип связи.
 	int type() const {
@@ -91,6 +89,19 @@ public:
 		_element = el;
 	}
 
+	//! Возвращает элемент триггера, от которого идет связь.
+	/**
+	Задается только для исходящих связей (qdTriggerElement::children()),
+	элемент получает уведомления о включении/выключении связи.
+	*/
+	qdTriggerElementPtr owner() const {
+		return _owner;
+	}
+	//! Устанавливает элемент триггера, от которого идет связь.
+	void set_owner(qdTriggerElementPtr p) {
+		_owner = p;
+	}
+
 	//! Возвращает идентификатор элемента, к которому идет связь.
 	int element_ID() const {
 		return _element_ID;
@@ -135,6 +146,8 @@ private:
 	int _type;
 	//! Элемент, к которому направлена связь.
 	qdTriggerElementPtr _element;
+	//! Элемент, от которого идет связь.
+	qdTriggerElementPtr _owner;
 	//! Идентификатор элемента, к которому направлена связь.
 	int _element_ID;
 
@@ -264,6 +277,34 @@ public:
 	void reset();
 	void deactivate(const qdNamedObject *ignore_object = NULL);
 
+	//! Возвращает количество включенных связей, идущих от элемента.
+	/**
+	Элемент без включенных исходящих связей ничего не делает в quant().
+	*/
+	int active_child_links() const {
+		return _active_child_links;
+	}
+	//! Вызывается исходящей связью при смене ее состояния.
+	void child_link_status_changed(qdTriggerLink::LinkStatus old_status, qdTriggerLink::LinkStatus new_status);
+
+	//! Устанавливает цепочку, которой принадлежит элемент, и номер элемента в ней.
+	void set_chain(qdTriggerChain *p, int index) {
+		_chain = p;
+		_chain_index = index;
+	}
+	//! Номер элемента в списке элементов цепочки.
+	int chain_index() const {
+		return _chain_index;
+	}
+
+	//! Находится ли элемент в списке активных элементов цепочки.
+	bool is_in_active_list() const {
+		return _is_in_active_list;
+	}
+	void toggle_active_list(bool state) {
+		_is_in_active_list = state;
+	}
+
 private:
 
 	//! Специальные состояния - используются только в сэйве.
@@ -286,6 +327,15 @@ private:
 	qdTriggerLinkList _parents;
 	qdTriggerLinkList _children;
 
+	//! Количество включенных связей в _children.
+	int _active_child_links;
+
+	//! Цепочка, которой принадлежит элемент.
+	qdTriggerChain *_chain;
+	//! Номер элемента в списке элементов цепочки, задает порядок обсчета.
+	int _chain_index;
+	bool _is_in_active_list;
+
 	bool load_links_script(const xml::tag *p, bool load_parents);
 
 	bool activate_links(qdTriggerElementPtr child);
@@ -0,0 +1,123 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/system.h"
+
+#include "qdengine/qdengine.h"
+#include "qdengine/system/graphics/gr_dispatcher.h"
+#include "qdengine/system/graphics/gr_blend.h"
+
+
+namespace QDEngine {
+
+namespace gr_blend {
+
+AlphaLineFunc alphaLine565 = alphaLine565_scalar;
+AlphaLineFunc alphaLine565Reverse = alphaLine565Reverse_scalar;
+FillLineFunc fillLine16 = fillLine16_scalar;
+FillAlphaLineFunc fillAlphaLine565 = fillAlphaLine565_scalar;
+
+void alphaLine565_scalar(uint16 *dst, const byte *src, int count) {
+	for (int i = 0; i < count; i++) {
+		uint32 a = src[3];
+		if (a != 255) {
+			if (a)
+				*dst = grDispatcher::alpha_blend_565(grDispatcher::make_rgb565u(src[2], src[1], src[0]), *dst, a);
+			else
+				*dst = grDispatcher::make_rgb565u(src[2], src[1], src[0]);
+		}
+		dst++;
+		src += 4;
+	}
+}
+
+void alphaLine565Reverse_scalar(uint16 *dst, const byte *src, int count) {
+	for (int i = 0; i < count; i++) {
+		uint32 a = src[3];
+		if (a != 255) {
+			if (a)
+				*dst = grDispatcher::alpha_blend_565(grDispatcher::make_rgb565u(src[2], src[1], src[0]), *dst, a);
+			else
+				*dst = grDispatcher::make_rgb565u(src[2], src[1], src[0]);
+		}
+		dst--;
+		src += 4;
+	}
+}
+
+void fillLine16_scalar(uint16 *dst, uint16 color, int count) {
+	for (int i = 0; i < count; i++)
+		*dst++ = color;
+}
+
+void fillAlphaLine565_scalar(uint16 *dst, uint16 color, uint32 alpha, int count) {
+	for (int i = 0; i < count; i++) {
+		*dst = grDispatcher::alpha_blend_565(color, *dst, alpha);
+		dst++;
+	}
+}
+
+void init() {
+	alphaLine565 = alphaLine565_scalar;
+	alphaLine565Reverse = alphaLine565Reverse_scalar;
+	fillLine16 = fillLine16_scalar;
+	fillAlphaLine565 = fillAlphaLine565_scalar;
+
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) {
+		alphaLine565 = alphaLine565_neon;
+		alphaLine565Reverse = alphaLine565Reverse_neon;
+		fillLine16 = fillLine16_neon;
+		fillAlphaLine565 = fillAlphaLine565_neon;
+		debugC(1, kDebugGraphics, "gr_blend::init(): using NEON kernels");
+		return;
+	}
+#endif
+
+#ifdef SCUMMVM_AVX2
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) {
+		alphaLine565 = alphaLine565_avx2;
+		alphaLine565Reverse = alphaLine565Reverse_avx2;
+		fillLine16 = fillLine16_avx2;
+		fillAlphaLine565 = fillAlphaLine565_avx2;
+		debugC(1, kDebugGraphics, "gr_blend::init(): using AVX2 kernels");
+		return;
+	}
+#endif
+
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) {
+		alphaLine565 = alphaLine565_sse2;
+		alphaLine565Reverse = alphaLine565Reverse_sse2;
+		fillLine16 = fillLine16_sse2;
+		fillAlphaLine565 = fillAlphaLine565_sse2;
+		debugC(1, kDebugGraphics, "gr_blend::init(): using SSE2 kernels");
+		return;
+	}
+#endif
+
+	debugC(1, kDebugGraphics, "gr_blend::init(): using scalar kernels");
+}
+
+} // namespace gr_blend
+
+} // namespace QDEngine
@@ -0,0 +1,84 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef QDENGINE_SYSTEM_GRAPHICS_GR_BLEND_H
+#define QDENGINE_SYSTEM_GRAPHICS_GR_BLEND_H
+
+#include "common/scummsys.h"
+
+namespace QDEngine {
+
+/// Ядра построчного альфа-смешивания 32-битных BGRA спрайтов с экраном RGB565.
+
+/// Все реализации дают результат, побитово совпадающий с grDispatcher::alpha_blend_565():
+/// пикселы с альфой 255 не меняют экран, остальные смешиваются.
+/// Прямой вариант пишет src[i] в dst[i], обратный (для GR_FLIP_HORIZONTAL) - в dst[-i].
+namespace gr_blend {
+
+typedef void (*AlphaLineFunc)(uint16 *dst, const byte *src, int count);
+
+extern AlphaLineFunc alphaLine565;
+extern AlphaLineFunc alphaLine565Reverse;
+
+/// Заливка строки экрана цветом color.
+typedef void (*FillLineFunc)(uint16 *dst, uint16 color, int count);
+/// Смешивание строки экрана с цветом color, как alpha_blend_565(color, dst[i], alpha).
+/// color должен быть заранее умножен на (255 - alpha), см. grDispatcher::rectangleAlpha().
+typedef void (*FillAlphaLineFunc)(uint16 *dst, uint16 color, uint32 alpha, int count);
+
+extern FillLineFunc fillLine16;
+extern FillAlphaLineFunc fillAlphaLine565;
+
+/// Выбирает самые быстрые ядра, поддерживаемые процессором.
+void init();
+
+void alphaLine565_scalar(uint16 *dst, const byte *src, int count);
+void alphaLine565Reverse_scalar(uint16 *dst, const byte *src, int count);
+void fillLine16_scalar(uint16 *dst, uint16 color, int count);
+void fillAlphaLine565_scalar(uint16 *dst, uint16 color, uint32 alpha, int count);
+
+#ifdef SCUMMVM_SSE2
+void alphaLine565_sse2(uint16 *dst, const byte *src, int count);
+void alphaLine565Reverse_sse2(uint16 *dst, const byte *src, int count);
+void fillLine16_sse2(uint16 *dst, uint16 color, int count);
+void fillAlphaLine565_sse2(uint16 *dst, uint16 color, uint32 alpha, int count);
+#endif
+
+#ifdef SCUMMVM_AVX2
+void alphaLine565_avx2(uint16 *dst, const byte *src, int count);
+void alphaLine565Reverse_avx2(uint16 *dst, const byte *src, int count);
+void fillLine16_avx2(uint16 *dst, uint16 color, int count);
+void fillAlphaLine565_avx2(uint16 *dst, uint16 color, uint32 alpha, int count);
+#endif
+
+#ifdef SCUMMVM_NEON
+void alphaLine565_neon(uint16 *dst, const byte *src, int count);
+void alphaLine565Reverse_neon(uint16 *dst, const byte *src, int count);
+void fillLine16_neon(uint16 *dst, uint16 color, int count);
+void fillAlphaLine565_neon(uint16 *dst, uint16 color, uint32 alpha, int count);
+#endif
+
+} // namespace gr_blend
+
+} // namespace QDEngine
+
+#endif // QDENGINE_SYSTEM_GRAPHICS_GR_BLEND_H
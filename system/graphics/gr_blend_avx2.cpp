@@ -0,0 +1,130 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <immintrin.h>
+
+#include "common/scummsys.h"
+
+#include "qdengine/system/graphics/gr_blend.h"
+
+
+namespace QDEngine {
+
+namespace gr_blend {
+
+namespace {
+
+/// 8 пикселов BGRA -> 8 пикселов RGB565 в 32-битных ячейках.
+inline __m256i bgraTo565(__m256i p) {
+	__m256i r = _mm256_and_si256(_mm256_srli_epi32(p, 8), _mm256_set1_epi32(0xF800));
+	__m256i g = _mm256_and_si256(_mm256_srli_epi32(p, 5), _mm256_set1_epi32(0x07E0));
+	__m256i b = _mm256_and_si256(_mm256_srli_epi32(p, 3), _mm256_set1_epi32(0x001F));
+	return _mm256_or_si256(r, _mm256_or_si256(g, b));
+}
+
+/// Упаковка младших 16 бит двух векторов без насыщения, с восстановлением порядка пикселов.
+inline __m256i packLow16(__m256i lo, __m256i hi) {
+	lo = _mm256_srai_epi32(_mm256_slli_epi32(lo, 16), 16);
+	hi = _mm256_srai_epi32(_mm256_slli_epi32(hi, 16), 16);
+	return _mm256_permute4x64_epi64(_mm256_packs_epi32(lo, hi), _MM_SHUFFLE(3, 1, 2, 0));
+}
+
+inline __m256i reverse16(__m256i x) {
+	const __m256i mask = _mm256_setr_epi8(14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1,
+	                                      14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1);
+	return _mm256_permute4x64_epi64(_mm256_shuffle_epi8(x, mask), _MM_SHUFFLE(1, 0, 3, 2));
+}
+
+/// Векторный аналог grDispatcher::alpha_blend_565() для 16 пикселов.
+inline __m256i blend565(__m256i pic, __m256i a, __m256i scr) {
+	__m256i r = _mm256_srli_epi16(_mm256_mullo_epi16(_mm256_srli_epi16(scr, 11), a), 8);
+	__m256i g = _mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(scr, 5), _mm256_set1_epi16(0x3F)), a), 8);
+	__m256i b = _mm256_srli_epi16(_mm256_mullo_epi16(_mm256_and_si256(scr, _mm256_set1_epi16(0x1F)), a), 8);
+
+	__m256i res = _mm256_add_epi16(pic, _mm256_or_si256(_mm256_slli_epi16(r, 11), _mm256_or_si256(_mm256_slli_epi16(g, 5), b)));
+
+	__m256i opaque = _mm256_cmpeq_epi16(a, _mm256_set1_epi16(255));
+	return _mm256_blendv_epi8(res, scr, opaque);
+}
+
+inline void load16(const byte *src, __m256i &pic, __m256i &a) {
+	__m256i p0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src));
+	__m256i p1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + 32));
+
+	pic = packLow16(bgraTo565(p0), bgraTo565(p1));
+	a = _mm256_permute4x64_epi64(_mm256_packs_epi32(_mm256_srli_epi32(p0, 24), _mm256_srli_epi32(p1, 24)), _MM_SHUFFLE(3, 1, 2, 0));
+}
+
+} // namespace
+
+void alphaLine565_avx2(uint16 *dst, const byte *src, int count) {
+	int i = 0;
+	for (; i + 16 <= count; i += 16) {
+		__m256i pic, a;
+		load16(src + i * 4, pic, a);
+
+		__m256i *scr_ptr = reinterpret_cast<__m256i *>(dst + i);
+		_mm256_storeu_si256(scr_ptr, blend565(pic, a, _mm256_loadu_si256(scr_ptr)));
+	}
+
+	alphaLine565_scalar(dst + i, src + i * 4, count - i);
+}
+
+void alphaLine565Reverse_avx2(uint16 *dst, const byte *src, int count) {
+	int i = 0;
+	for (; i + 16 <= count; i += 16) {
+		__m256i pic, a;
+		load16(src + i * 4, pic, a);
+
+		__m256i *scr_ptr = reinterpret_cast<__m256i *>(dst - i - 15);
+		_mm256_storeu_si256(scr_ptr, blend565(reverse16(pic), reverse16(a), _mm256_loadu_si256(scr_ptr)));
+	}
+
+	alphaLine565Reverse_scalar(dst - i, src + i * 4, count - i);
+}
+
+void fillLine16_avx2(uint16 *dst, uint16 color, int count) {
+	const __m256i cl = _mm256_set1_epi16(color);
+
+	int i = 0;
+	for (; i + 16 <= count; i += 16)
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), cl);
+
+	fillLine16_scalar(dst + i, color, count - i);
+}
+
+void fillAlphaLine565_avx2(uint16 *dst, uint16 color, uint32 alpha, int count) {
+	const __m256i pic = _mm256_set1_epi16(color);
+	const __m256i a = _mm256_set1_epi16(alpha);
+
+	int i = 0;
+	for (; i + 16 <= count; i += 16) {
+		__m256i *scr_ptr = reinterpret_cast<__m256i *>(dst + i);
+		_mm256_storeu_si256(scr_ptr, blend565(pic, a, _mm256_loadu_si256(scr_ptr)));
+	}
+
+	fillAlphaLine565_scalar(dst + i, color, alpha, count - i);
+}
+
+} // namespace gr_blend
+
+} // namespace QDEngine
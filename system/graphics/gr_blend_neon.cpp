@@ -0,0 +1,114 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <arm_neon.h>
+
+#include "common/scummsys.h"
+
+#include "qdengine/system/graphics/gr_blend.h"
+
+
+namespace QDEngine {
+
+namespace gr_blend {
+
+namespace {
+
+inline uint16x8_t reverse16(uint16x8_t x) {
+	x = vrev64q_u16(x);
+	return vcombine_u16(vget_high_u16(x), vget_low_u16(x));
+}
+
+/// Векторный аналог grDispatcher::alpha_blend_565() для 8 пикселов.
+inline uint16x8_t blend565(uint16x8_t pic, uint16x8_t a, uint16x8_t scr) {
+	uint16x8_t r = vshrq_n_u16(vmulq_u16(vshrq_n_u16(scr, 11), a), 8);
+	uint16x8_t g = vshrq_n_u16(vmulq_u16(vandq_u16(vshrq_n_u16(scr, 5), vdupq_n_u16(0x3F)), a), 8);
+	uint16x8_t b = vshrq_n_u16(vmulq_u16(vandq_u16(scr, vdupq_n_u16(0x1F)), a), 8);
+
+	uint16x8_t res = vaddq_u16(pic, vorrq_u16(vshlq_n_u16(r, 11), vorrq_u16(vshlq_n_u16(g, 5), b)));
+
+	return vbslq_u16(vceqq_u16(a, vdupq_n_u16(255)), scr, res);
+}
+
+inline void load8(const byte *src, uint16x8_t &pic, uint16x8_t &a) {
+	uint8x8x4_t p = vld4_u8(src);
+
+	uint16x8_t r = vshlq_n_u16(vmovl_u8(vshr_n_u8(p.val[2], 3)), 11);
+	uint16x8_t g = vshlq_n_u16(vmovl_u8(vshr_n_u8(p.val[1], 2)), 5);
+	uint16x8_t b = vmovl_u8(vshr_n_u8(p.val[0], 3));
+
+	pic = vorrq_u16(r, vorrq_u16(g, b));
+	a = vmovl_u8(p.val[3]);
+}
+
+} // namespace
+
+void alphaLine565_neon(uint16 *dst, const byte *src, int count) {
+	int i = 0;
+	for (; i + 8 <= count; i += 8) {
+		uint16x8_t pic, a;
+		load8(src + i * 4, pic, a);
+
+		uint16 *scr_ptr = dst + i;
+		vst1q_u16(scr_ptr, blend565(pic, a, vld1q_u16(scr_ptr)));
+	}
+
+	alphaLine565_scalar(dst + i, src + i * 4, count - i);
+}
+
+void alphaLine565Reverse_neon(uint16 *dst, const byte *src, int count) {
+	int i = 0;
+	for (; i + 8 <= count; i += 8) {
+		uint16x8_t pic, a;
+		load8(src + i * 4, pic, a);
+
+		uint16 *scr_ptr = dst - i - 7;
+		vst1q_u16(scr_ptr, blend565(reverse16(pic), reverse16(a), vld1q_u16(scr_ptr)));
+	}
+
+	alphaLine565Reverse_scalar(dst - i, src + i * 4, count - i);
+}
+
+void fillLine16_neon(uint16 *dst, uint16 color, int count) {
+	const uint16x8_t cl = vdupq_n_u16(color);
+
+	int i = 0;
+	for (; i + 8 <= count; i += 8)
+		vst1q_u16(dst + i, cl);
+
+	fillLine16_scalar(dst + i, color, count - i);
+}
+
+void fillAlphaLine565_neon(uint16 *dst, uint16 color, uint32 alpha, int count) {
+	const uint16x8_t pic = vdupq_n_u16(color);
+	const uint16x8_t a = vdupq_n_u16(alpha);
+
+	int i = 0;
+	for (; i + 8 <= count; i += 8)
+		vst1q_u16(dst + i, blend565(pic, a, vld1q_u16(dst + i)));
+
+	fillAlphaLine565_scalar(dst + i, color, alpha, count - i);
+}
+
+} // namespace gr_blend
+
+} // namespace QDEngine
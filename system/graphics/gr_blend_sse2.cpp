@@ -0,0 +1,130 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <emmintrin.h>
+
+#include "common/scummsys.h"
+
+#include "qdengine/system/graphics/gr_blend.h"
+
+
+namespace QDEngine {
+
+namespace gr_blend {
+
+namespace {
+
+/// 4 пиксела BGRA -> 4 пиксела RGB565 в 32-битных ячейках.
+inline __m128i bgraTo565(__m128i p) {
+	__m128i r = _mm_and_si128(_mm_srli_epi32(p, 8), _mm_set1_epi32(0xF800));
+	__m128i g = _mm_and_si128(_mm_srli_epi32(p, 5), _mm_set1_epi32(0x07E0));
+	__m128i b = _mm_and_si128(_mm_srli_epi32(p, 3), _mm_set1_epi32(0x001F));
+	return _mm_or_si128(r, _mm_or_si128(g, b));
+}
+
+/// Упаковка младших 16 бит двух векторов без насыщения.
+inline __m128i packLow16(__m128i lo, __m128i hi) {
+	lo = _mm_srai_epi32(_mm_slli_epi32(lo, 16), 16);
+	hi = _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16);
+	return _mm_packs_epi32(lo, hi);
+}
+
+inline __m128i reverse16(__m128i x) {
+	x = _mm_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2));
+	x = _mm_shufflelo_epi16(x, _MM_SHUFFLE(0, 1, 2, 3));
+	return _mm_shufflehi_epi16(x, _MM_SHUFFLE(0, 1, 2, 3));
+}
+
+/// Векторный аналог grDispatcher::alpha_blend_565() для 8 пикселов.
+inline __m128i blend565(__m128i pic, __m128i a, __m128i scr) {
+	__m128i r = _mm_srli_epi16(_mm_mullo_epi16(_mm_srli_epi16(scr, 11), a), 8);
+	__m128i g = _mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(scr, 5), _mm_set1_epi16(0x3F)), a), 8);
+	__m128i b = _mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(scr, _mm_set1_epi16(0x1F)), a), 8);
+
+	__m128i res = _mm_add_epi16(pic, _mm_or_si128(_mm_slli_epi16(r, 11), _mm_or_si128(_mm_slli_epi16(g, 5), b)));
+
+	__m128i opaque = _mm_cmpeq_epi16(a, _mm_set1_epi16(255));
+	return _mm_or_si128(_mm_and_si128(opaque, scr), _mm_andnot_si128(opaque, res));
+}
+
+inline void load8(const byte *src, __m128i &pic, __m128i &a) {
+	__m128i p0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+	__m128i p1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 16));
+
+	pic = packLow16(bgraTo565(p0), bgraTo565(p1));
+	a = _mm_packs_epi32(_mm_srli_epi32(p0, 24), _mm_srli_epi32(p1, 24));
+}
+
+} // namespace
+
+void alphaLine565_sse2(uint16 *dst, const byte *src, int count) {
+	int i = 0;
+	for (; i + 8 <= count; i += 8) {
+		__m128i pic, a;
+		load8(src + i * 4, pic, a);
+
+		__m128i *scr_ptr = reinterpret_cast<__m128i *>(dst + i);
+		_mm_storeu_si128(scr_ptr, blend565(pic, a, _mm_loadu_si128(scr_ptr)));
+	}
+
+	alphaLine565_scalar(dst + i, src + i * 4, count - i);
+}
+
+void alphaLine565Reverse_sse2(uint16 *dst, const byte *src, int count) {
+	int i = 0;
+	for (; i + 8 <= count; i += 8) {
+		__m128i pic, a;
+		load8(src + i * 4, pic, a);
+
+		__m128i *scr_ptr = reinterpret_cast<__m128i *>(dst - i - 7);
+		_mm_storeu_si128(scr_ptr, blend565(reverse16(pic), reverse16(a), _mm_loadu_si128(scr_ptr)));
+	}
+
+	alphaLine565Reverse_scalar(dst - i, src + i * 4, count - i);
+}
+
+void fillLine16_sse2(uint16 *dst, uint16 color, int count) {
+	const __m128i cl = _mm_set1_epi16(color);
+
+	int i = 0;
+	for (; i + 8 <= count; i += 8)
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), cl);
+
+	fillLine16_scalar(dst + i, color, count - i);
+}
+
+void fillAlphaLine565_sse2(uint16 *dst, uint16 color, uint32 alpha, int count) {
+	const __m128i pic = _mm_set1_epi16(color);
+	const __m128i a = _mm_set1_epi16(alpha);
+
+	int i = 0;
+	for (; i + 8 <= count; i += 8) {
+		__m128i *scr_ptr = reinterpret_cast<__m128i *>(dst + i);
+		_mm_storeu_si128(scr_ptr, blend565(pic, a, _mm_loadu_si128(scr_ptr)));
+	}
+
+	fillAlphaLine565_scalar(dst + i, color, alpha, count - i);
+}
+
+} // namespace gr_blend
+
+} // namespace QDEngine
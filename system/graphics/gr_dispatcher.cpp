@@ -30,6 +30,7 @@
 #include "qdengine/qdengine.h"
 #include "qdengine/qd_fwd.h"
 #include "qdengine/system/graphics/gr_dispatcher.h"
+#include "qdengine/system/graphics/gr_pixel_format.h"
 #include "qdengine/system/graphics/gr_font.h"
 #include "qdengine/system/graphics/UI_TextParser.h"
 
@@ -64,6 +65,8 @@ grDispatcher::grDispatcher() : _screenBuf(NULL),
 	_wndPosX = _wndPosY = 0;
 
 	_changes_mask_size_x = _changes_mask_size_y = 0;
+	_changes_bits_pitch = 0;
+	_changed_regions_mode = CHANGED_REGIONS_MERGE;
 
 	_hide_mouse = false;
 	_mouse_cursor = NULL;
@@ -76,6 +79,8 @@ grDispatcher::grDispatcher() : _screenBuf(NULL),
 grDispatcher::~grDispatcher() {
 	finit();
 
+	delete[] _temp_buffer;
+
 	if (_dispatcher_ptr == this) _dispatcher_ptr = 0;
 }
 
@@ -101,6 +106,8 @@ bool grDispatcher::init(int sx, int sy, grPixelFormat pixel_format) {
 
 	_pixel_format = pixel_format;
 
+	gr_blend::init();
+
 	initGraphics(sx, sy, &g_engine->_pixelformat);
 	_screenBuf = new Graphics::ManagedSurface(sx, sy, g_engine->_pixelformat);
 
@@ -114,6 +121,9 @@ bool grDispatcher::init(int sx, int sy, grPixelFormat pixel_format) {
 
 	_changes_mask.resize(_changes_mask_size_x * _changes_mask_size_y);
 
+	_changes_bits_pitch = (_changes_mask_size_x + 31) >> 5;
+	_changes_bits.resize(_changes_bits_pitch * _changes_mask_size_y);
+
 	_flags &= ~GR_REINIT;
 
 #ifdef _GR_ENABLE_ZBUFFER
@@ -127,6 +137,53 @@ void grDispatcher::fill(int val) {
 	_screenBuf->clear(val);
 }
 
+void grDispatcher::scroll(int dx, int dy) {
+	if (ABS(dx) >= _sizeX || ABS(dy) >= _sizeY)
+		return;
+
+	// Буфер сдвигается целиком. Пикселы, перенесённые сдвигом по x на соседнюю
+	// строку, попадают в открывшуюся полосу по x, которая всё равно перерисовывается.
+	byte *buf = (byte *)_screenBuf->getBasePtr(0, 0);
+	int size = _screenBuf->pitch * (_sizeY - 1) + _sizeX * sizeof(uint16);
+	int offset = dy * _screenBuf->pitch + dx * (int)sizeof(uint16);
+
+	if (offset > 0)
+		memmove(buf + offset, buf, size - offset);
+	else if (offset < 0)
+		memmove(buf, buf - offset, size + offset);
+}
+
+Graphics::ManagedSurface *grDispatcher::create_layer() const {
+	return new Graphics::ManagedSurface(_sizeX, _sizeY, g_engine->_pixelformat);
+}
+
+void grDispatcher::set_draw_surface(Graphics::ManagedSurface *surf) {
+	if (surf) {
+		if (!_screenSurface)
+			_screenSurface = _screenBuf;
+		_screenBuf = surf;
+	} else if (_screenSurface) {
+		_screenBuf = _screenSurface;
+		_screenSurface = nullptr;
+	}
+}
+
+void grDispatcher::put_layer(const Graphics::ManagedSurface *layer, int x, int y, int sx, int sy) {
+	if (_clipMode && !clip_rectangle(x, y, sx, sy))
+		return;
+
+	for (int i = 0; i < sy; i++)
+		memcpy(_screenBuf->getBasePtr(x, y + i), layer->getBasePtr(x, y + i), sx * sizeof(uint16));
+}
+
+void grDispatcher::grab_layer(Graphics::ManagedSurface *layer, int x, int y, int sx, int sy) const {
+	if (_clipMode && !clip_rectangle(x, y, sx, sy))
+		return;
+
+	for (int i = 0; i < sy; i++)
+		memcpy(layer->getBasePtr(x, y + i), _screenBuf->getBasePtr(x, y + i), sx * sizeof(uint16));
+}
+
 bool grDispatcher::flush(int x, int y, int sx, int sy) {
 	int x1 = x + sx;
 	int y1 = y + sy;
@@ -308,7 +365,10 @@ void grDispatcher::rectangle(int x, int y, int sx, int sy, int outcol, int incol
 	}
 }
 
-void grDispatcher::rectangleAlpha(int x, int y, int sx, int sy, uint32 color, int alpha) {
+template<class Pixel>
+void grDispatcher::rectangleAlpha_impl(int x, int y, int sx, int sy, uint32 color, int alpha) {
+	typedef typename Pixel::pixel_t pixel_t;
+
 	int px = 0;
 	int py = 0;
 
@@ -316,29 +376,20 @@ void grDispatcher::rectangleAlpha(int x, int y, int sx, int sy, uint32 color, in
 	int psy = sy;
 
 	if (!clip_rectangle(x, y, px, py, psx, psy)) return;
-	int dx = 1;
-	int dy = 1;
+
+	if (alpha >= 255) return;
 
 	byte mr, mg, mb;
-	split_rgb565u(color, mr, mg, mb);
+	Pixel::split(color, mr, mg, mb);
 
 	mr = (mr * (255 - alpha)) >> 8;
 	mg = (mg * (255 - alpha)) >> 8;
 	mb = (mb * (255 - alpha)) >> 8;
 
-	uint32 mcl = make_rgb565u(mr, mg, mb);
-
-	warning("STUB: grDispatcher::rectangleAlpha");
-	for (int i = 0; i < psy; i++) {
-		uint16 *scr_buf = reinterpret_cast<uint16 *>(_screenBuf->getBasePtr(x, y));
+	uint32 mcl = Pixel::make(mr, mg, mb);
 
-		for (int j = 0; j < psx; j++) {
-			*scr_buf = alpha_blend_565(mcl, *scr_buf, alpha);
-			scr_buf += dx;
-		}
-
-		y += dy;
-	}
+	for (int i = 0; i < psy; i++)
+		Pixel::fillAlphaLine(reinterpret_cast<pixel_t *>(_screenBuf->getBasePtr(x, y + i)), mcl, alpha, psx);
 }
 
 void grDispatcher::erase(int x, int y, int sx, int sy, int col) {
@@ -346,8 +397,13 @@ void grDispatcher::erase(int x, int y, int sx, int sy, int col) {
 		if (!clip_rectangle(x, y, sx, sy))
 			return;
 
-	_screenBuf->fillRect(Common::Rect(x, y, x + sx, y + sy), col);
-	return;
+	Common::Rect rect(x, y, x + sx, y + sy);
+	rect.clip(_screenBuf->w, _screenBuf->h);
+	if (rect.isEmpty())
+		return;
+
+	for (int i = rect.top; i < rect.bottom; i++)
+		(*gr_blend::fillLine16)(reinterpret_cast<uint16 *>(_screenBuf->getBasePtr(rect.left, i)), col, rect.width());
 }
 
 void grDispatcher::setPixel(int x, int y, int col) {
@@ -623,11 +679,24 @@ bool grDispatcher::clear_zbuffer() {
 
 void grDispatcher::clear_changes_mask() {
 	Common::fill(_changes_mask.begin(), _changes_mask.end(), 0);
+	Common::fill(_changes_bits.begin(), _changes_bits.end(), 0);
+}
+
+void grDispatcher::set_changed_regions_mode(ChangedRegionsMode mode) {
+	_changed_regions_mode = mode;
+	clear_changes_mask();
 }
 
 void grDispatcher::build_changed_regions() {
 	_changed_regions.clear();
 
+	if (_changed_regions_mode == CHANGED_REGIONS_MERGE)
+		build_merged_regions();
+	else
+		build_strip_regions();
+}
+
+void grDispatcher::build_strip_regions() {
 	bool flag = true;
 
 	while (flag) {
@@ -669,6 +738,261 @@ void grDispatcher::build_changed_regions() {
 	}
 }
 
+namespace {
+
+/// Номер первой клетки с заданным значением в строке маски, начиная с x.
+int find_changes_bit(const uint32 *row, int pitch, int x, bool value) {
+	int w = x >> 5;
+	if (w >= pitch)
+		return pitch << 5;
+
+	uint32 inv = value ? 0 : ~0U;
+	uint32 bits = (row[w] ^ inv) & (~0U << (x & 31));
+
+	while (!bits) {
+		if (++w >= pitch)
+			return pitch << 5;
+		bits = row[w] ^ inv;
+	}
+
+	x = w << 5;
+	while (!(bits & 1)) {
+		bits >>= 1;
+		x++;
+	}
+
+	return x;
+}
+
+} // namespace
+
+void grDispatcher::push_merge(int first, int second, int gain) {
+	ChangesMerge m;
+	m.gain = gain;
+	m.first = first;
+	m.first_version = _changes_rects[first].version;
+	m.second = second;
+	m.second_version = _changes_rects[second].version;
+
+	_changes_merges.push_back(m);
+
+	int i = _changes_merges.size() - 1;
+	while (i > 0) {
+		int parent = (i - 1) / 2;
+		if (!(_changes_merges[parent] < m))
+			break;
+		_changes_merges[i] = _changes_merges[parent];
+		i = parent;
+	}
+
+	_changes_merges[i] = m;
+}
+
+grDispatcher::ChangesMerge grDispatcher::pop_merge() {
+	Std::vector<ChangesMerge> &heap = _changes_merges;
+
+	ChangesMerge top = heap[0];
+	ChangesMerge m = heap.back();
+	heap.pop_back();
+
+	int size = heap.size();
+	if (!size)
+		return top;
+
+	int i = 0;
+	for (;;) {
+		int child = i * 2 + 1;
+		if (child >= size)
+			break;
+		if (child + 1 < size && heap[child] < heap[child + 1])
+			child++;
+		if (!(m < heap[child]))
+			break;
+		heap[i] = heap[child];
+		i = child;
+	}
+
+	heap[i] = m;
+	return top;
+}
+
+void grDispatcher::find_merge_partner(int idx) {
+	const ChangesRect &r = _changes_rects[idx];
+
+	int partner = -1;
+	int best_gain = 0;
+
+	for (uint i = 0; i < _changes_rects.size(); i++) {
+		const ChangesRect &r1 = _changes_rects[i];
+		if ((int)i == idx || r1.removed || !r.is_near(r1))
+			continue;
+
+		int gain = r.merge_gain(r1);
+		if (gain >= best_gain) {
+			partner = i;
+			best_gain = gain;
+		}
+	}
+
+	if (partner != -1)
+		push_merge(idx, partner, best_gain);
+}
+
+void grDispatcher::merge_changes_buckets() {
+	Std::vector<ChangesRect> &rects = _changes_rects;
+
+	ChangesRect buckets[kChangesBuckets * kChangesBuckets];
+	for (int i = 0; i < kChangesBuckets * kChangesBuckets; i++)
+		buckets[i].removed = true;
+
+	const int bucket_sx = (_changes_mask_size_x + kChangesBuckets - 1) / kChangesBuckets;
+	const int bucket_sy = (_changes_mask_size_y + kChangesBuckets - 1) / kChangesBuckets;
+
+	for (uint i = 0; i < rects.size(); i++) {
+		const ChangesRect &r = rects[i];
+		if (r.removed)
+			continue;
+
+		int bx = MIN(((r.x0 + r.x1) / 2) / bucket_sx, kChangesBuckets - 1);
+		int by = MIN(((r.y0 + r.y1) / 2) / bucket_sy, kChangesBuckets - 1);
+
+		ChangesRect &b = buckets[by * kChangesBuckets + bx];
+		if (b.removed)
+			b = r;
+		else
+			b.merge(r);
+	}
+
+	rects.clear();
+	for (int i = 0; i < kChangesBuckets * kChangesBuckets; i++) {
+		if (!buckets[i].removed)
+			rects.push_back(buckets[i]);
+	}
+}
+
+void grDispatcher::build_merged_regions() {
+	Std::vector<ChangesRect> &rects = _changes_rects;
+	rects.clear();
+
+	// Отрезки строк. Отрезки, между которыми меньше kChangesRegionCost пустых
+	// клеток, объединяются, одинаковые отрезки соседних строк - тоже.
+	int row_start = 0;
+	for (int y = 0; y < _changes_mask_size_y; y++) {
+		const uint32 *row = &_changes_bits[y * _changes_bits_pitch];
+		int prev_row_end = rects.size();
+
+		int x = find_changes_bit(row, _changes_bits_pitch, 0, true);
+		while (x < _changes_mask_size_x) {
+			int x0 = x;
+			int x1 = find_changes_bit(row, _changes_bits_pitch, x0, false);
+
+			for (;;) {
+				x = find_changes_bit(row, _changes_bits_pitch, x1, true);
+				if (x >= _changes_mask_size_x || x - x1 > kChangesRegionCost)
+					break;
+				x1 = find_changes_bit(row, _changes_bits_pitch, x, false);
+			}
+
+			if (x1 > _changes_mask_size_x)
+				x1 = _changes_mask_size_x;
+
+			bool extended = false;
+			for (int i = row_start; i < prev_row_end; i++) {
+				ChangesRect &r = rects[i];
+				if (r.y1 == y && r.x0 == x0 && r.x1 == x1) {
+					r.y1++;
+					extended = true;
+					break;
+				}
+			}
+
+			if (!extended)
+				rects.push_back(ChangesRect(x0, y, x1, y + 1));
+		}
+
+		// прямоугольники, не продолженные в этой строке, дальше не растут
+		while (row_start < prev_row_end && rects[row_start].y1 <= y)
+			row_start++;
+	}
+
+	// Жадное слияние: из очереди берётся пара соседних прямоугольников с
+	// наибольшим выигрышем, рамка пары поглощает попавшие в неё прямоугольники.
+	// Стоимость прямоугольника - его площадь плюс kChangesRegionCost.
+	// Устаревшие пары из очереди пропускаются, для прямоугольника, чей
+	// кандидат изменился, кандидат ищется заново.
+	_changes_merges.clear();
+
+	int count = rects.size();
+	for (int i = 0; i < count; i++)
+		find_merge_partner(i);
+
+	while (!_changes_merges.empty()) {
+		ChangesMerge m = pop_merge();
+
+		ChangesRect &r = rects[m.first];
+		if (r.removed || r.version != m.first_version)
+			continue;
+
+		const ChangesRect &r1 = rects[m.second];
+		if (r1.removed || r1.version != m.second_version) {
+			find_merge_partner(m.first);
+			continue;
+		}
+
+		r.merge(r1);
+		rects[m.second].removed = true;
+		count--;
+
+		bool grown = true;
+		while (grown) {
+			grown = false;
+			for (uint i = 0; i < rects.size(); i++) {
+				ChangesRect &r2 = rects[i];
+				if ((int)i != m.first && !r2.removed && r.intersects(r2)) {
+					r.merge(r2);
+					r2.removed = true;
+					count--;
+					grown = true;
+				}
+			}
+		}
+
+		r.version++;
+
+		find_merge_partner(m.first);
+
+		// соседям выросший прямоугольник может стать выгоднее их прежних кандидатов
+		for (uint i = 0; i < rects.size(); i++) {
+			const ChangesRect &r2 = rects[i];
+			if ((int)i == m.first || r2.removed || !r2.is_near(r))
+				continue;
+
+			int gain = r2.merge_gain(r);
+			if (gain >= 0)
+				push_merge(i, m.first, gain);
+		}
+	}
+
+	if (count > kChangesMaxRects)
+		merge_changes_buckets();
+
+	for (uint i = 0; i < rects.size(); i++) {
+		const ChangesRect &r = rects[i];
+		if (r.removed)
+			continue;
+
+		int x = r.x0 << kChangesMaskTileShift;
+		int y = r.y0 << kChangesMaskTileShift;
+
+		int sx = (r.x1 - r.x0) << kChangesMaskTileShift;
+		int sy = (r.y1 - r.y0) << kChangesMaskTileShift;
+
+		_changed_regions.push_back(grScreenRegion(x + sx / 2, y + sy / 2, sx, sy));
+	}
+
+	Common::fill(_changes_bits.begin(), _changes_bits.end(), 0);
+}
+
 bool grDispatcher::invalidate_region(const grScreenRegion &reg) {
 	int x = reg.min_x();
 	int y = reg.min_y();
@@ -688,6 +1012,28 @@ bool grDispatcher::invalidate_region(const grScreenRegion &reg) {
 
 		if (sx <= 0 || sy <= 0) return false;
 
+		if (_changed_regions_mode == CHANGED_REGIONS_MERGE) {
+			int w0 = x >> 5;
+			int w1 = (x + sx - 1) >> 5;
+
+			uint32 mask0 = ~0U << (x & 31);
+			uint32 mask1 = ~0U >> (31 - ((x + sx - 1) & 31));
+
+			uint32 *row = &_changes_bits[y * _changes_bits_pitch];
+			for (int i = 0; i < sy; i++, row += _changes_bits_pitch) {
+				if (w0 == w1) {
+					row[w0] |= mask0 & mask1;
+				} else {
+					row[w0] |= mask0;
+					for (int w = w0 + 1; w < w1; w++)
+						row[w] = ~0U;
+					row[w1] |= mask1;
+				}
+			}
+
+			return true;
+		}
+
 		changes_mask_t::iterator it = _changes_mask.begin() + (x + y * _changes_mask_size_x);
 
 		for (int i = 0; i < sy; i++) {
@@ -848,7 +1194,7 @@ char *grDispatcher::temp_buffer(int size) {
 	if (size <= 0) size = 1;
 
 	if (size > _temp_buffer_size) {
-		delete _temp_buffer;
+		delete[] _temp_buffer;
 		_temp_buffer = new char[size];
 		_temp_buffer_size = size;
 	}
@@ -856,6 +1202,21 @@ char *grDispatcher::temp_buffer(int size) {
 	return _temp_buffer;
 }
 
+const int *grDispatcher::scale_columns(int k0, int k1, int d, int pixel_size) {
+	if ((int)_scale_columns.size() < k1 - k0)
+		_scale_columns.resize(k1 - k0);
+
+	int *ptr = &_scale_columns[0];
+
+	int fx = (1 << 15) + k0 * d;
+	for (int k = k0; k < k1; k++) {
+		*ptr++ = (fx >> 16) * pixel_size;
+		fx += d;
+	}
+
+	return &_scale_columns[0];
+}
+
 bool grDispatcher::drawText(int x, int y, uint32 color, const char *str, int hspace, int vspace, const grFont *font) {
 	if (!font)
 		font = _default_font;
@@ -1049,4 +1410,8 @@ int grDispatcher::textHeight(const char *str, int vspace, const grFont *font) co
 	return sy;
 }
 
+void grDispatcher::rectangleAlpha(int x, int y, int sx, int sy, uint32 color, int alpha) {
+	rectangleAlpha_impl<grPixelRGB565>(x, y, sx, sy, color, alpha);
+}
+
 } // namespace QDEngine
@@ -178,6 +178,17 @@ public:
 	bool flushChanges();
 
 	void fill(int val);
+	//! Сдвигает изображение на (dx, dy), открывшиеся полосы не перерисовываются.
+	void scroll(int dx, int dy);
+
+	//! Создаёт внеэкранный слой того же размера и формата, что экран.
+	Graphics::ManagedSurface *create_layer() const;
+	//! Переключает вывод на слой, 0 - обратно на экран.
+	void set_draw_surface(Graphics::ManagedSurface *surf);
+	//! Копирует прямоугольник слоя в то же место экрана, с учётом отсечения.
+	void put_layer(const Graphics::ManagedSurface *layer, int x, int y, int sx, int sy);
+	//! Копирует прямоугольник экрана в то же место слоя, с учётом отсечения.
+	void grab_layer(Graphics::ManagedSurface *layer, int x, int y, int sx, int sy) const;
 
 	void putSpr(int x, int y, int sx, int sy, const byte *p, int mode, int spriteFormat);
 	void putSpr(int x, int y, int sx, int sy, const byte *p, int mode, int spriteFormat, float scale);
@@ -204,6 +215,12 @@ public:
 	void putSprMask_a(int x, int y, int sx, int sy, const byte *p, uint32 mask_color, int mask_alpha, int mode, float scale);
 
 	void putTileSpr(int x, int y, const grTileSprite &sprite, bool has_alpha, int mode);
+	/// Вывод с поворотом кадра, составленного из тайлов.
+	/**
+	tiles - указатели на данные тайлов кадра по строкам, tiles_size - размеры кадра в тайлах,
+	нулевой указатель - полностью прозрачный тайл.
+	*/
+	void putTileSpr_rot(const Vect2i &pos, const Vect2i &size, const uint32 *const *tiles, const Vect2i &tiles_size, bool has_alpha, int mode, float angle);
 
 	void putChar(int x, int y, uint32 color, int font_sx, int font_sy, const byte *font_alpha, const grScreenRegion &char_region);
 
@@ -262,6 +279,16 @@ public:
 		_pixel_format = GR_RGB565;
 	}
 
+	//! Формат пикселов экранной поверхности.
+	/**
+	Экран всегда создается в g_engine->_pixelformat (RGB565), независимо
+	от pixel_format() из настроек игры, по нему выбирается формат
+	данных rleBuffer::convert_native().
+	*/
+	grPixelFormat screen_format() const {
+		return GR_RGB565;
+	}
+
 	inline int bytes_per_pixel() const {
 		return 2;
 	}
@@ -438,6 +465,19 @@ public:
 	void build_changed_regions();
 	bool invalidate_region(const grScreenRegion &reg);
 
+	//! Способ построения областей перерисовки.
+	enum ChangedRegionsMode {
+		//! Полосы из клеток маски изменений.
+		CHANGED_REGIONS_STRIPS,
+		//! Слияние прямоугольников с оценкой стоимости перерисовки.
+		CHANGED_REGIONS_MERGE
+	};
+
+	ChangedRegionsMode changed_regions_mode() const {
+		return _changed_regions_mode;
+	}
+	void set_changed_regions_mode(ChangedRegionsMode mode);
+
 	static inline grDispatcher *instance() {
 		return _dispatcher_ptr;
 	}
@@ -496,6 +536,8 @@ protected:
 	void *_hWnd;
 
 	Graphics::ManagedSurface *_screenBuf = nullptr;
+	/// экранный буфер на время вывода в слой, см. set_draw_surface()
+	Graphics::ManagedSurface *_screenSurface = nullptr;
 
 	int *_yTable;
 
@@ -551,7 +593,12 @@ private:
 
 	enum {
 		kChangesMaskTile = 16,
-		kChangesMaskTileShift = 4
+		kChangesMaskTileShift = 4,
+		/// накладные расходы на одну область перерисовки, в клетках маски
+		kChangesRegionCost = 16,
+		/// если прямоугольников больше - они объединяются по сетке kChangesBuckets x kChangesBuckets
+		kChangesMaxRects = 64,
+		kChangesBuckets = 8
 	};
 
 	int _changes_mask_size_x;
@@ -559,8 +606,170 @@ private:
 
 	changes_mask_t _changes_mask;
 
+	ChangedRegionsMode _changed_regions_mode;
+
+	/// маска изменений для CHANGED_REGIONS_MERGE, по биту на клетку
+	int _changes_bits_pitch;
+	Std::vector<uint32> _changes_bits;
+
 	regions_container_t _changed_regions;
 
+	/// Прямоугольник из клеток маски изменений, правая и нижняя границы не включаются.
+	struct ChangesRect {
+		int x0, y0, x1, y1;
+
+		/// увеличивается при каждом изменении прямоугольника, см. ChangesMerge
+		int version;
+		/// прямоугольник поглощён другим
+		bool removed;
+
+		ChangesRect() : x0(0), y0(0), x1(0), y1(0), version(0), removed(false) { }
+		ChangesRect(int left, int top, int right, int bottom) : x0(left), y0(top), x1(right), y1(bottom), version(0), removed(false) { }
+
+		int area() const {
+			return (x1 - x0) * (y1 - y0);
+		}
+		bool intersects(const ChangesRect &r) const {
+			return x0 < r.x1 && r.x0 < x1 && y0 < r.y1 && r.y0 < y1;
+		}
+		/// Прямоугольники ближе kChangesRegionCost клеток по обеим осям.
+		/**
+		Слияние более далёких прямоугольников всегда невыгодно.
+		*/
+		bool is_near(const ChangesRect &r) const {
+			return r.x0 - x1 <= kChangesRegionCost && x0 - r.x1 <= kChangesRegionCost &&
+			       r.y0 - y1 <= kChangesRegionCost && y0 - r.y1 <= kChangesRegionCost;
+		}
+		void merge(const ChangesRect &r) {
+			if (r.x0 < x0) x0 = r.x0;
+			if (r.y0 < y0) y0 = r.y0;
+			if (r.x1 > x1) x1 = r.x1;
+			if (r.y1 > y1) y1 = r.y1;
+		}
+		/// Выигрыш от замены двух прямоугольников их общей рамкой.
+		int merge_gain(const ChangesRect &r) const {
+			ChangesRect u(x0, y0, x1, y1);
+			u.merge(r);
+			return area() + r.area() + kChangesRegionCost - u.area();
+		}
+	};
+
+	/// Кандидат на слияние прямоугольников first и second.
+	/**
+	Устаревает, если любой из прямоугольников изменился после
+	постановки в очередь (не совпадают версии).
+	*/
+	struct ChangesMerge {
+		int gain;
+		int first;
+		int first_version;
+		int second;
+		int second_version;
+
+		bool operator < (const ChangesMerge &m) const {
+			return gain < m.gain;
+		}
+	};
+
+	/// рабочий список прямоугольников build_merged_regions()
+	Std::vector<ChangesRect> _changes_rects;
+	/// очередь слияний build_merged_regions(), двоичная куча по выигрышу
+	Std::vector<ChangesMerge> _changes_merges;
+
+	void build_strip_regions();
+	void build_merged_regions();
+	/// Ставит в очередь выгодное слияние _changes_rects[idx] с соседом, если оно есть.
+	void find_merge_partner(int idx);
+	void push_merge(int first, int second, int gain);
+	/// Извлекает из очереди слияние с наибольшим выигрышем.
+	ChangesMerge pop_merge();
+	/// Объединяет прямоугольники по крупной сетке, когда их больше kChangesMaxRects.
+	void merge_changes_buckets();
+
+	/// смещения исходных пикселов для масштабированного вывода, см. scale_columns()
+	Std::vector<int> _scale_columns;
+
+	/// Отсечение масштабированного вывода по одной оси.
+	/**
+	Пиксел k из [0, count) выводится в точку start + k * step,
+	в [k0, k1) возвращаются пикселы, попадающие в [clip0, clip1).
+	*/
+	static bool clip_scaled(int start, int step, int count, int clip0, int clip1, int &k0, int &k1) {
+		if (step > 0) {
+			k0 = clip0 - start;
+			k1 = clip1 - start;
+		} else {
+			k0 = start - clip1 + 1;
+			k1 = start - clip0 + 1;
+		}
+
+		if (k0 < 0) k0 = 0;
+		if (k1 > count) k1 = count;
+
+		return k0 < k1;
+	}
+
+	/// Смещения исходных пикселов для пикселов [k0, k1) масштабированной строки.
+	/**
+	d - шаг по исходной строке в формате 16.16, pixel_size - размер исходного пиксела.
+	*/
+	const int *scale_columns(int k0, int k1, int d, int pixel_size);
+
+	/// Параметры вывода с поворотом, см. rotate_setup().
+	struct RotateParams {
+		int x0, y0;         ///< левый верхний угол области вывода
+		int sx, sy;         ///< последний пиксел области вывода относительно (x0, y0)
+		int xx, yy;         ///< координаты в спрайте для точки (x0, y0)
+		int cos_a, sin_a;   ///< приращения координат в спрайте при сдвиге на пиксел экрана
+		int scale_x;        ///< масштаб в формате 16.16, 0 - без масштабирования
+		int scale_y;
+		int max_xx, max_yy; ///< пределы координат в спрайте
+		int min_xx, min_yy;
+	};
+
+	bool rotate_setup(const Vect2i &pos, const Vect2i &size, float angle, bool fix_axes, RotateParams &prm) const;
+	bool rotate_setup(const Vect2i &pos, const Vect2i &size, float angle, const Vect2f &scale, RotateParams &prm) const;
+
+	/// Отрезок [x_begin, x_end] строки y области вывода, который попадает внутрь спрайта.
+	/**
+	В xx, yy возвращаются координаты в спрайте для x_begin.
+	*/
+	static bool rotate_span(const RotateParams &prm, int y, int &x_begin, int &x_end, int &xx, int &yy);
+
+	//! Блиттеры для формата пикселов экрана, см. gr_pixel_format.h.
+	/**
+	Экран всегда RGB565, поэтому публичные putSpr*() и rectangleAlpha()
+	вызывают инстанцирование для grPixelRGB565 напрямую.
+	*/
+	template<class Pixel> void putSpr_impl(int x, int y, int sx, int sy, const byte *p, int mode, int spriteFormat);
+	template<class Pixel> void putSpr_impl(int x, int y, int sx, int sy, const byte *p, int mode, int spriteFormat, float scale);
+	template<class Pixel> void putSpr_a_impl(int x, int y, int sx, int sy, const byte *p, int mode);
+	template<class Pixel> void putSpr_a_impl(int x, int y, int sx, int sy, const byte *p, int mode, float scale);
+	template<class Pixel> void putSprMask_impl(int x, int y, int sx, int sy, const byte *p, uint32 mask_color, int mask_alpha, int mode);
+	template<class Pixel> void putSprMask_impl(int x, int y, int sx, int sy, const byte *p, uint32 mask_color, int mask_alpha, int mode, float scale);
+	template<class Pixel> void putSprMask_a_impl(int x, int y, int sx, int sy, const byte *p, uint32 mask_color, int mask_alpha, int mode);
+	template<class Pixel> void putSprMask_a_impl(int x, int y, int sx, int sy, const byte *p, uint32 mask_color, int mask_alpha, int mode, float scale);
+
+	template<class Pixel> void putSpr_rle_impl(int x, int y, int sx, int sy, const rleBuffer *p, int mode, bool alpha_flag);
+	template<class Pixel> void putSpr_rle_impl(int x, int y, int sx, int sy, const rleBuffer *p, int mode, float scale, bool alpha_flag);
+	template<class Pixel> void putSprMask_rle_impl(int x, int y, int sx, int sy, const rleBuffer *p, uint32 mask_color, int mask_alpha, int mode, bool alpha_flag);
+	template<class Pixel> void putSprMask_rle_impl(int x, int y, int sx, int sy, const rleBuffer *p, uint32 mask_color, int mask_alpha, int mode, float scale, bool alpha_flag);
+
+	template<class Pixel> void rectangleAlpha_impl(int x, int y, int sx, int sy, uint32 color, int alpha);
+
+	static inline int rotate_coord(int v, int scale) {
+		return scale ? v / scale : v >> 16;
+	}
+
+	/// Диапазон строк спрайта, которые понадобятся при выводе с поворотом.
+	static bool rotate_rows(const RotateParams &prm, const Vect2i &size, int mode, int &row_min, int &row_max);
+
+	void putSpr_rot_spans(const RotateParams &prm, const Vect2i &size, const byte *data, bool has_alpha, int mode);
+	void putSprMask_rot_spans(const RotateParams &prm, const Vect2i &size, const byte *data, bool has_alpha, uint32 mask_color, int mask_alpha, int mode);
+
+	/// Распаковка в temp_buffer() строк RLE-спрайта, нужных для вывода с поворотом.
+	const byte *decode_rot_rows(const RotateParams &prm, const Vect2i &size, const rleBuffer *data, bool has_alpha, int mode);
+
 	static char_input_hanler_t _input_handler;
 
 	static grFont *_default_font;
@@ -25,69 +25,78 @@
 
 #include "qdengine/qdengine.h"
 #include "qdengine/system/graphics/gr_dispatcher.h"
+#include "qdengine/system/graphics/gr_pixel_format.h"
 
 namespace QDEngine {
 
-void grDispatcher::putSpr_a(int x, int y, int sx, int sy, const byte *p, int mode, float scale) {
-	debugC(2, kDebugGraphics, "grDispatcher::putSpr_a(%d, %d, %d, %d, scale=%f)", x, y, sx, sy, scale);
+template<class Pixel>
+void grDispatcher::putSpr_a_impl(int x, int y, int sx, int sy, const byte *p, int mode, float scale) {
+	typedef typename Pixel::pixel_t pixel_t;
 
-	int i, j, sx_dest, sy_dest;
+	debugC(2, kDebugGraphics, "grDispatcher::putSpr_a(%d, %d, %d, %d, scale=%f)", x, y, sx, sy, scale);
 
-	sx_dest = round(float(sx) * scale);
-	sy_dest = round(float(sy) * scale);
+	int sx_dest = round(float(sx) * scale);
+	int sy_dest = round(float(sy) * scale);
 
 	if (!sx_dest || !sy_dest) return;
 
 	int dx = (sx << 16) / sx_dest;
 	int dy = (sy << 16) / sy_dest;
-	int fx = (1 << 15);
-	int fy = (1 << 15);
 
 	int x0 = 0;
-	int x1 = sx_dest;
 	int ix = 1;
 
 	int y0 = 0;
-	int y1 = sy_dest;
 	int iy = 1;
 
 	if (mode & GR_FLIP_VERTICAL) {
-		y0 = sy_dest,
-		y1 = 0;
+		y0 = sy_dest;
 		iy = -1;
 	}
 
 	if (mode & GR_FLIP_HORIZONTAL) {
-		x0 = sx_dest,
-		x1 = 0;
+		x0 = sx_dest;
 		ix = -1;
 	}
 
+	int count_x = sx_dest;
+	int count_y = sy_dest;
+
+	int kx0, kx1, ky0, ky1;
+	if (!clip_scaled(x + x0, ix, count_x, _clipCoords[GR_LEFT], _clipCoords[GR_RIGHT], kx0, kx1)) return;
+	if (!clip_scaled(y + y0, iy, count_y, _clipCoords[GR_TOP], _clipCoords[GR_BOTTOM], ky0, ky1)) return;
+
+	x += x0 + kx0 * ix;
+	count_x = kx1 - kx0;
+
+	const int *columns = scale_columns(kx0, kx1, dx, 4);
+
 	sx *= 4;
-	for (i = y0; i != y1; i += iy) {
+	int fy = (1 << 15) + ky0 * dy;
+	for (int i = ky0; i < ky1; i++) {
 		const byte *line_src = p + ((fy >> 16) * sx);
-
 		fy += dy;
-		fx = (1 << 15);
 
-		for (j = x0; j != x1; j += ix) {
-			const byte *src_data = line_src + (fx >> 16) * 4;
+		pixel_t *scr_buf = reinterpret_cast<pixel_t *>(_screenBuf->getBasePtr(x, y + y0 + i * iy));
+		for (int j = 0; j < count_x; j++) {
+			const byte *src_data = line_src + columns[j];
 			uint32 a = src_data[3];
 
-			if (a != 255 && clipCheck(x + j, y + i)) {
-				if (a) {
-					uint16 sc;
-					getPixel(x + j, y + i, sc);
-					setPixel(x + j, y + i, alpha_blend_565(make_rgb565u(src_data[2], src_data[1], src_data[0]), sc, a));
-				} else
-					setPixel(x + j, y + i, make_rgb565u(src_data[2], src_data[1], src_data[0]));
+			if (a != 255) {
+				if (a)
+					*scr_buf = Pixel::blend(Pixel::make(src_data[2], src_data[1], src_data[0]), *scr_buf, a);
+				else
+					*scr_buf = Pixel::make(src_data[2], src_data[1], src_data[0]);
 			}
-			fx += dx;
+			scr_buf += ix;
 		}
 	}
 }
 
-void grDispatcher::putSpr(int x, int y, int sx, int sy, const byte *p, int mode, int spriteFormat, float scale) {
+template<class Pixel>
+void grDispatcher::putSpr_impl(int x, int y, int sx, int sy, const byte *p, int mode, int spriteFormat, float scale) {
+	typedef typename Pixel::pixel_t pixel_t;
+
 	debugC(2, kDebugGraphics, "grDispatcher::putSpr(%d, %d, %d, %d, scale=%f)", x, y, sx, sy, scale);
 
 	int sx_dest = round(float(sx) * scale);
@@ -97,47 +106,55 @@ void grDispatcher::putSpr(int x, int y, int sx, int sy, const byte *p, int mode,
 
 	int dx = (sx << 16) / sx_dest;
 	int dy = (sy << 16) / sy_dest;
-	int fx = (1 << 15);
-	int fy = (1 << 15);
 
 	int x0 = 0;
-	int x1 = sx_dest;
 	int ix = 1;
 
 	int y0 = 0;
-	int y1 = sy_dest;
 	int iy = 1;
 
 	if (mode & GR_FLIP_VERTICAL) {
-		y0 = sy_dest,
-		y1 = 0;
+		y0 = sy_dest;
 		iy = -1;
 	}
 
 	if (mode & GR_FLIP_HORIZONTAL) {
-		x0 = sx_dest,
-		x1 = 0;
+		x0 = sx_dest;
 		ix = -1;
 	}
-	const uint16 *src = reinterpret_cast<const uint16 *>(p);
 
-	for (int i = y0; i != y1; i += iy) {
-		const uint16 *line_src = src + ((fy >> 16) * sx);
+	int count_x = sx_dest;
+	int count_y = sy_dest;
+
+	int kx0, kx1, ky0, ky1;
+	if (!clip_scaled(x + x0, ix, count_x, _clipCoords[GR_LEFT], _clipCoords[GR_RIGHT], kx0, kx1)) return;
+	if (!clip_scaled(y + y0, iy, count_y, _clipCoords[GR_TOP], _clipCoords[GR_BOTTOM], ky0, ky1)) return;
+
+	x += x0 + kx0 * ix;
+	count_x = kx1 - kx0;
 
+	const int *columns = scale_columns(kx0, kx1, dx, 1);
+	const pixel_t *src = reinterpret_cast<const pixel_t *>(p);
+
+	int fy = (1 << 15) + ky0 * dy;
+	for (int i = ky0; i < ky1; i++) {
+		const pixel_t *line_src = src + ((fy >> 16) * sx);
 		fy += dy;
-		fx = (1 << 15);
 
-		for (int j = x0; j != x1; j += ix) {
-			uint32 cl = line_src[fx >> 16];
+		pixel_t *scr_buf = reinterpret_cast<pixel_t *>(_screenBuf->getBasePtr(x, y + y0 + i * iy));
+		for (int j = 0; j < count_x; j++) {
+			uint32 cl = line_src[columns[j]];
 			if (cl)
-				setPixel(x + j, y + i, cl);
-			fx += dx;
+				*scr_buf = cl;
+			scr_buf += ix;
 		}
 	}
-	return;
 }
 
-void grDispatcher::putSpr_a(int x, int y, int sx, int sy, const byte *p, int mode) {
+template<class Pixel>
+void grDispatcher::putSpr_a_impl(int x, int y, int sx, int sy, const byte *p, int mode) {
+	typedef typename Pixel::pixel_t pixel_t;
+
 	debugC(2, kDebugGraphics, "grDispatcher::putSpr_a(%d, %d, %d, %d)", x, y, sx, sy);
 
 	int px = 0;
@@ -167,28 +184,16 @@ void grDispatcher::putSpr_a(int x, int y, int sx, int sy, const byte *p, int mod
 
 	const byte *data_ptr = p + py * sx;
 	for (int i = 0; i < psy; i++) {
-		uint16 *scr_buf = reinterpret_cast<uint16 *>(_screenBuf->getBasePtr(x, y));
-		const byte *data_line = data_ptr + px;
-
-		for (int j = 0; j < psx; j++) {
-			uint32 a = data_line[3];
-			if (a != 255) {
-				if (a)
-					*scr_buf = alpha_blend_565(make_rgb565u(data_line[2], data_line[1], data_line[0]), *scr_buf, a);
-				else
-					*scr_buf = make_rgb565u(data_line[2], data_line[1], data_line[0]);
-			}
+		pixel_t *scr_buf = reinterpret_cast<pixel_t *>(_screenBuf->getBasePtr(x, y));
+		Pixel::alphaLine(scr_buf, data_ptr + px, psx, dx);
 
-			scr_buf += dx;
-			data_line += 4;
-		}
 		data_ptr += sx;
 		y += dy;
 	}
 	return;
 }
 
-void grDispatcher::putSpr_rot(const Vect2i &pos, const Vect2i &size, const byte *data, bool has_alpha, int mode, float angle) {
+bool grDispatcher::rotate_setup(const Vect2i &pos, const Vect2i &size, float angle, bool fix_axes, RotateParams &prm) const {
 	const int F_PREC = 16;
 
 	int xc = pos.x + size.x / 2;
@@ -206,7 +211,7 @@ void grDispatcher::putSpr_rot(const Vect2i &pos, const Vect2i &size, const byte
 	int dx = 0;
 	int dy = 0;
 
-	if (!(int)(round(R2G(angle))) % 90) {
+	if (fix_axes && !(int)(round(R2G(angle))) % 90) {
 		int angle_num = round(cycleAngle(angle) / (M_PI / 2.f));
 		switch (angle_num) {
 		case 1:
@@ -223,77 +228,29 @@ void grDispatcher::putSpr_rot(const Vect2i &pos, const Vect2i &size, const byte
 	}
 
 	if (!clip_rectangle(x0, y0, sx, sy))
-		return;
-
-	int sin_a = round(sn * float(1 << F_PREC));
-	int cos_a = round(cs * float(1 << F_PREC));
-
-	if (has_alpha) {
-		for (int y = 0; y <= sy; y++) {
-					uint16 *screen_ptr = (uint16 *)(_screenBuf + _yTable[y + y0] + x0 * 2);
+		return false;
 
-					int xx = (x0 - xc) * cos_a + (y + y0 - yc) * sin_a + ((size.x + 1 + dx) << (F_PREC - 1));
-					int yy = (y + y0 - yc) * cos_a - (x0 - xc) * sin_a + ((size.y + 1 + dy) << (F_PREC - 1));
+	prm.x0 = x0;
+	prm.y0 = y0;
+	prm.sx = sx;
+	prm.sy = sy;
 
-					for (int x = 0; x <= sx; x++) {
-						int xb = (xx >> F_PREC);
-						int yb = (yy >> F_PREC);
+	prm.sin_a = round(sn * float(1 << F_PREC));
+	prm.cos_a = round(cs * float(1 << F_PREC));
 
-						if (xb >= 0 && xb < size.x && yb >= 0 && yb < size.y) {
-							if (mode & GR_FLIP_HORIZONTAL)
-								xb = size.x - xb - 1;
-							if (mode & GR_FLIP_VERTICAL)
-								yb = size.y - yb - 1;
+	prm.xx = (x0 - xc) * prm.cos_a + (y0 - yc) * prm.sin_a + ((size.x + 1 + dx) << (F_PREC - 1));
+	prm.yy = (y0 - yc) * prm.cos_a - (x0 - xc) * prm.sin_a + ((size.y + 1 + dy) << (F_PREC - 1));
 
-							const byte *data_ptr = data + size.x * 4 * yb + xb * 4;
+	prm.scale_x = prm.scale_y = 0;
 
-							uint32 a = data_ptr[3];
-							if (a != 255) {
-								if (a)
-									*screen_ptr = alpha_blend_565(make_rgb565u(data_ptr[2], data_ptr[1], data_ptr[0]), *screen_ptr, a);
-								else
-									*screen_ptr = make_rgb565u(data_ptr[2], data_ptr[1], data_ptr[0]);
-							}
-						}
+	prm.min_xx = prm.min_yy = 0;
+	prm.max_xx = (size.x << F_PREC) - 1;
+	prm.max_yy = (size.y << F_PREC) - 1;
 
-						xx += cos_a;
-						yy -= sin_a;
-
-						screen_ptr++;
-					}
-				}
-	} else {
-		for (int y = 0; y <= sy; y++) {
-			uint16 *screen_ptr = (uint16 *)(_screenBuf + _yTable[y + y0] + x0 * 2);
-
-			int xx = (x0 - xc) * cos_a + (y + y0 - yc) * sin_a + ((size.x + 1 + dx) << (F_PREC - 1));
-			int yy = (y + y0 - yc) * cos_a - (x0 - xc) * sin_a + ((size.y + 1 + dy) << (F_PREC - 1));
-
-			for (int x = 0; x <= sx; x++) {
-				int xb = (xx >> F_PREC);
-				int yb = (yy >> F_PREC);
-
-				if (xb >= 0 && xb < size.x && yb >= 0 && yb < size.y) {
-					if (mode & GR_FLIP_HORIZONTAL)
-						xb = size.x - xb - 1;
-					if (mode & GR_FLIP_VERTICAL)
-						yb = size.y - yb - 1;
-
-					const byte *data_ptr = data + size.x * 3 * yb + xb * 3;
-					if (data_ptr[0] || data_ptr[1] || data_ptr[2])
-						*screen_ptr = make_rgb565u(data_ptr[2], data_ptr[1], data_ptr[0]);
-				}
-
-				xx += cos_a;
-				yy -= sin_a;
-
-				screen_ptr++;
-			}
-		}
-	}
+	return true;
 }
 
-void grDispatcher::putSpr_rot(const Vect2i &pos, const Vect2i &size, const byte *data, bool has_alpha, int mode, float angle, const Vect2f &scale) {
+bool grDispatcher::rotate_setup(const Vect2i &pos, const Vect2i &size, float angle, const Vect2f &scale, RotateParams &prm) const {
 	const int F_PREC = 16;
 
 	int xc = pos.x + round(float(size.x) * scale.x / 2.f);
@@ -309,287 +266,242 @@ void grDispatcher::putSpr_rot(const Vect2i &pos, const Vect2i &size, const byte
 	int y0 = yc - sy / 2;
 
 	if (!clip_rectangle(x0, y0, sx, sy))
-		return;
-
-	int sin_a = round(sinf(angle) * float(1 << F_PREC));
-	int cos_a = round(cosf(angle) * float(1 << F_PREC));
+		return false;
 
 	Vect2i iscale = Vect2i(round(scale.x * float(1 << F_PREC)), round(scale.y * float(1 << F_PREC)));
-	Vect2i scaled_size = Vect2i(iscale.x * size.x, iscale.y * size.y);
-
-	if (has_alpha) {
-		for (int y = 0; y <= sy; y++) {
-					uint16 *screen_ptr = (uint16 *)(_screenBuf + _yTable[y + y0] + x0 * 2);
-
-					int xx = (x0 - xc) * cos_a + (y + y0 - yc) * sin_a + scaled_size.x / 2 + (1 << (F_PREC - 1));
-					int yy = (y + y0 - yc) * cos_a - (x0 - xc) * sin_a + scaled_size.y / 2 + (1 << (F_PREC - 1));
-
-					for (int x = 0; x <= sx; x++) {
-						int xb = xx / iscale.x;
-						int yb = yy / iscale.y;
-
-						if (xb >= 0 && xb < size.x && yb >= 0 && yb < size.y) {
-							if (mode & GR_FLIP_HORIZONTAL)
-								xb = size.x - xb - 1;
-							if (mode & GR_FLIP_VERTICAL)
-								yb = size.y - yb - 1;
-
-							const byte *data_ptr = data + size.x * 4 * yb + xb * 4;
-
-							uint32 a = data_ptr[3];
-							if (a != 255) {
-								if (a)
-									*screen_ptr = alpha_blend_565(make_rgb565u(data_ptr[2], data_ptr[1], data_ptr[0]), *screen_ptr, a);
-								else
-									*screen_ptr = make_rgb565u(data_ptr[2], data_ptr[1], data_ptr[0]);
-							}
-						}
+	if (iscale.x <= 0 || iscale.y <= 0)
+		return false;
 
-						xx += cos_a;
-						yy -= sin_a;
+	Vect2i scaled_size = Vect2i(iscale.x * size.x, iscale.y * size.y);
 
-						screen_ptr++;
-					}
-				}
-	} else {
-		for (int y = 0; y <= sy; y++) {
-			uint16 *screen_ptr = (uint16 *)(_screenBuf + _yTable[y + y0] + x0 * 2);
+	prm.x0 = x0;
+	prm.y0 = y0;
+	prm.sx = sx;
+	prm.sy = sy;
 
-			int xx = (x0 - xc) * cos_a + (y + y0 - yc) * sin_a + scaled_size.x / 2 + (1 << (F_PREC - 1));
-			int yy = (y + y0 - yc) * cos_a - (x0 - xc) * sin_a + scaled_size.y / 2 + (1 << (F_PREC - 1));
+	prm.sin_a = round(sn * float(1 << F_PREC));
+	prm.cos_a = round(cs * float(1 << F_PREC));
 
-			for (int x = 0; x <= sx; x++) {
-				int xb = xx / iscale.x;
-				int yb = yy / iscale.y;
+	prm.xx = (x0 - xc) * prm.cos_a + (y0 - yc) * prm.sin_a + scaled_size.x / 2 + (1 << (F_PREC - 1));
+	prm.yy = (y0 - yc) * prm.cos_a - (x0 - xc) * prm.sin_a + scaled_size.y / 2 + (1 << (F_PREC - 1));
 
-				if (xb >= 0 && xb < size.x && yb >= 0 && yb < size.y) {
-					if (mode & GR_FLIP_HORIZONTAL)
-						xb = size.x - xb - 1;
-					if (mode & GR_FLIP_VERTICAL)
-						yb = size.y - yb - 1;
+	prm.scale_x = iscale.x;
+	prm.scale_y = iscale.y;
 
-					const byte *data_ptr = data + size.x * 3 * yb + xb * 3;
-					*screen_ptr = make_rgb565u(data_ptr[2], data_ptr[1], data_ptr[0]);
-				}
+	// координаты делятся на масштаб с отбрасыванием дробной части,
+	// поэтому отрицательные значения больше -scale тоже дают нулевой пиксел
+	prm.min_xx = -(iscale.x - 1);
+	prm.min_yy = -(iscale.y - 1);
+	prm.max_xx = scaled_size.x - 1;
+	prm.max_yy = scaled_size.y - 1;
 
-				xx += cos_a;
-				yy -= sin_a;
-
-				screen_ptr++;
-			}
-		}
-	}
+	return true;
 }
 
-void grDispatcher::putSprMask_rot(const Vect2i &pos, const Vect2i &size, const byte *data, bool has_alpha, uint32 mask_color, int mask_alpha, int mode, float angle) {
-	const int F_PREC = 16;
-
-	int xc = pos.x + size.x / 2;
-	int yc = pos.y + size.y / 2;
+namespace {
 
-	float sn = sinf(angle);
-	float cs = cosf(angle);
+inline int64 div_floor(int64 a, int64 b) {
+	int64 q = a / b;
+	if ((a % b) && ((a < 0) != (b < 0)))
+		q--;
+	return q;
+}
 
-	int sx = round(fabs(cs) * float(size.x) + fabs(sn) * float(size.y)) + 2;
-	int sy = round(fabs(sn) * float(size.x) + fabs(cs) * float(size.y)) + 2;
+inline int64 div_ceil(int64 a, int64 b) {
+	return -div_floor(-a, b);
+}
 
-	int x0 = xc - sx / 2;
-	int y0 = yc - sy / 2;
+/// Сужает [x_begin, x_end] до значений x, для которых min_v <= v + x * dv <= max_v.
+inline bool clip_span(int64 v, int64 dv, int64 min_v, int64 max_v, int &x_begin, int &x_end) {
+	int64 x0, x1;
+	if (dv > 0) {
+		x0 = div_ceil(min_v - v, dv);
+		x1 = div_floor(max_v - v, dv);
+	} else if (dv < 0) {
+		x0 = div_ceil(max_v - v, dv);
+		x1 = div_floor(min_v - v, dv);
+	} else {
+		return v >= min_v && v <= max_v && x_begin <= x_end;
+	}
 
-	if (!clip_rectangle(x0, y0, sx, sy))
-		return;
+	if (x0 > x_begin) x_begin = x0;
+	if (x1 < x_end) x_end = x1;
 
-	int sin_a = round(sn * float(1 << F_PREC));
-	int cos_a = round(cs * float(1 << F_PREC));
+	return x_begin <= x_end;
+}
 
-	if (has_alpha) {
-		byte mr, mg, mb;
-		split_rgb565u(mask_color, mr, mg, mb);
+} // namespace
 
-		for (int y = 0; y <= sy; y++) {
-			uint16 *screen_ptr = (uint16 *)(_screenBuf + _yTable[y + y0] + x0 * 2);
+bool grDispatcher::rotate_span(const RotateParams &prm, int y, int &x_begin, int &x_end, int &xx, int &yy) {
+	int row_xx = prm.xx + y * prm.sin_a;
+	int row_yy = prm.yy + y * prm.cos_a;
 
-			int xx = (x0 - xc) * cos_a + (y + y0 - yc) * sin_a + (size.x + 1) * (1 << (F_PREC - 1));
-			int yy = (y + y0 - yc) * cos_a - (x0 - xc) * sin_a + (size.y + 1) * (1 << (F_PREC - 1));
+	x_begin = 0;
+	x_end = prm.sx;
 
-			for (int x = 0; x <= sx; x++) {
-				int xb = (xx >> F_PREC);
-				int yb = (yy >> F_PREC);
+	if (!clip_span(row_xx, prm.cos_a, prm.min_xx, prm.max_xx, x_begin, x_end))
+		return false;
+	if (!clip_span(row_yy, -prm.sin_a, prm.min_yy, prm.max_yy, x_begin, x_end))
+		return false;
 
-				if (xb >= 0 && xb < size.x && yb >= 0 && yb < size.y) {
-					if (mode & GR_FLIP_HORIZONTAL)
-						xb = size.x - xb - 1;
-					if (mode & GR_FLIP_VERTICAL)
-						yb = size.y - yb - 1;
+	xx = row_xx + x_begin * prm.cos_a;
+	yy = row_yy - x_begin * prm.sin_a;
 
-					const byte *data_ptr = data + size.x * 4 * yb + xb * 4;
+	return true;
+}
 
-					uint32 a = data_ptr[3];
-					if (a != 255) {
-						a = mask_alpha + ((a * (255 - mask_alpha)) >> 8);
+bool grDispatcher::rotate_rows(const RotateParams &prm, const Vect2i &size, int mode, int &row_min, int &row_max) {
+	row_min = size.y;
+	row_max = -1;
 
-						uint32 r = (mr * (255 - a)) >> 8;
-						uint32 g = (mg * (255 - a)) >> 8;
-						uint32 b = (mb * (255 - a)) >> 8;
+	for (int y = 0; y <= prm.sy; y++) {
+		int x_begin, x_end, xx, yy;
+		if (!rotate_span(prm, y, x_begin, x_end, xx, yy))
+			continue;
 
-						uint32 cl = make_rgb565u(r, g, b);
+		int yb0 = rotate_coord(yy, prm.scale_y);
+		int yb1 = rotate_coord(yy - (x_end - x_begin) * prm.sin_a, prm.scale_y);
 
-						*screen_ptr = alpha_blend_565(cl, *screen_ptr, a);
-					}
-				}
+		row_min = MIN(row_min, MIN(yb0, yb1));
+		row_max = MAX(row_max, MAX(yb0, yb1));
+	}
 
-				xx += cos_a;
-				yy -= sin_a;
+	if (row_min > row_max)
+		return false;
 
-				screen_ptr++;
-			}
-		}
+	if (mode & GR_FLIP_VERTICAL) {
+		int tmp = size.y - row_max - 1;
+		row_max = size.y - row_min - 1;
+		row_min = tmp;
+	}
 
-	} else {
-		byte mr, mg, mb;
-		split_rgb565u(mask_color, mr, mg, mb);
+	return true;
+}
 
-		mr = (mr * (255 - mask_alpha)) >> 8;
-		mg = (mg * (255 - mask_alpha)) >> 8;
-		mb = (mb * (255 - mask_alpha)) >> 8;
+void grDispatcher::putSpr_rot_spans(const RotateParams &prm, const Vect2i &size, const byte *data, bool has_alpha, int mode) {
+	int psx = has_alpha ? 4 : 3;
 
-		uint32 mcl = make_rgb565u(mr, mg, mb);
+	for (int y = 0; y <= prm.sy; y++) {
+		int x_begin, x_end, xx, yy;
+		if (!rotate_span(prm, y, x_begin, x_end, xx, yy))
+			continue;
 
-		for (int y = 0; y <= sy; y++) {
-			uint16 *screen_ptr = (uint16 *)(_screenBuf + _yTable[y + y0] + x0 * 2);
+		uint16 *screen_ptr = reinterpret_cast<uint16 *>(_screenBuf->getBasePtr(prm.x0 + x_begin, prm.y0 + y));
 
-			int xx = (x0 - xc) * cos_a + (y + y0 - yc) * sin_a + (size.x + 1) * (1 << (F_PREC - 1));
-			int yy = (y + y0 - yc) * cos_a - (x0 - xc) * sin_a + (size.y + 1) * (1 << (F_PREC - 1));
+		for (int x = x_begin; x <= x_end; x++) {
+			int xb = rotate_coord(xx, prm.scale_x);
+			int yb = rotate_coord(yy, prm.scale_y);
 
-			for (int x = 0; x <= sx; x++) {
-				int xb = (xx >> F_PREC);
-				int yb = (yy >> F_PREC);
+			if (mode & GR_FLIP_HORIZONTAL)
+				xb = size.x - xb - 1;
+			if (mode & GR_FLIP_VERTICAL)
+				yb = size.y - yb - 1;
 
-				if (xb >= 0 && xb < size.x && yb >= 0 && yb < size.y) {
-					if (mode & GR_FLIP_HORIZONTAL)
-						xb = size.x - xb - 1;
-					if (mode & GR_FLIP_VERTICAL)
-						yb = size.y - yb - 1;
+			const byte *data_ptr = data + (size.x * yb + xb) * psx;
 
-					const byte *data_ptr = data + size.x * 3 * yb + xb * 3;
-					if (data_ptr[0] || data_ptr[1] || data_ptr[2]) {
-						*screen_ptr = alpha_blend_565(mcl, *screen_ptr, mask_alpha);
-					}
+			if (has_alpha) {
+				uint32 a = data_ptr[3];
+				if (a != 255) {
+					if (a)
+						*screen_ptr = alpha_blend_565(make_rgb565u(data_ptr[2], data_ptr[1], data_ptr[0]), *screen_ptr, a);
+					else
+						*screen_ptr = make_rgb565u(data_ptr[2], data_ptr[1], data_ptr[0]);
 				}
+			} else if (data_ptr[0] || data_ptr[1] || data_ptr[2])
+				*screen_ptr = make_rgb565u(data_ptr[2], data_ptr[1], data_ptr[0]);
 
-				xx += cos_a;
-				yy -= sin_a;
+			xx += prm.cos_a;
+			yy -= prm.sin_a;
 
-				screen_ptr++;
-			}
+			screen_ptr++;
 		}
 	}
 }
 
-void grDispatcher::putSprMask_rot(const Vect2i &pos, const Vect2i &size, const byte *data, bool has_alpha, uint32 mask_color, int mask_alpha, int mode, float angle, const Vect2f &scale) {
-	const int F_PREC = 16;
-
-	int xc = pos.x + round(float(size.x) * scale.x / 2.f);
-	int yc = pos.y + round(float(size.y) * scale.y / 2.f);
-
-	float sn = sinf(angle);
-	float cs = cosf(angle);
-
-	int sx = round(fabs(cs) * float(size.x) * scale.x + fabs(sn) * float(size.y) * scale.y) + 2;
-	int sy = round(fabs(sn) * float(size.x) * scale.x + fabs(cs) * float(size.y) * scale.y) + 2;
-
-	int x0 = xc - sx / 2;
-	int y0 = yc - sy / 2;
-
-	if (!clip_rectangle(x0, y0, sx, sy))
-		return;
-
-	int sin_a = round(sinf(angle) * float(1 << F_PREC));
-	int cos_a = round(cosf(angle) * float(1 << F_PREC));
-
-	Vect2i iscale = Vect2i(round(scale.x * float(1 << F_PREC)), round(scale.y * float(1 << F_PREC)));
-	Vect2i scaled_size = Vect2i(iscale.x * size.x, iscale.y * size.y);
+void grDispatcher::putSprMask_rot_spans(const RotateParams &prm, const Vect2i &size, const byte *data, bool has_alpha, uint32 mask_color, int mask_alpha, int mode) {
+	byte mr, mg, mb;
+	split_rgb565u(mask_color, mr, mg, mb);
 
-	if (has_alpha) {
-		byte mr, mg, mb;
-		split_rgb565u(mask_color, mr, mg, mb);
+	uint32 mcl = make_rgb565u((mr * (255 - mask_alpha)) >> 8, (mg * (255 - mask_alpha)) >> 8, (mb * (255 - mask_alpha)) >> 8);
 
-		for (int y = 0; y <= sy; y++) {
-			uint16 *screen_ptr = (uint16 *)(_screenBuf + _yTable[y + y0] + x0 * 2);
+	int psx = has_alpha ? 4 : 3;
 
-			int xx = (x0 - xc) * cos_a + (y + y0 - yc) * sin_a + scaled_size.x / 2 + (1 << (F_PREC - 1));
-			int yy = (y + y0 - yc) * cos_a - (x0 - xc) * sin_a + scaled_size.y / 2 + (1 << (F_PREC - 1));
+	for (int y = 0; y <= prm.sy; y++) {
+		int x_begin, x_end, xx, yy;
+		if (!rotate_span(prm, y, x_begin, x_end, xx, yy))
+			continue;
 
-			for (int x = 0; x <= sx; x++) {
-				int xb = xx / iscale.x;
-				int yb = yy / iscale.y;
+		uint16 *screen_ptr = reinterpret_cast<uint16 *>(_screenBuf->getBasePtr(prm.x0 + x_begin, prm.y0 + y));
 
-				if (xb >= 0 && xb < size.x && yb >= 0 && yb < size.y) {
-					if (mode & GR_FLIP_HORIZONTAL)
-						xb = size.x - xb - 1;
-					if (mode & GR_FLIP_VERTICAL)
-						yb = size.y - yb - 1;
+		for (int x = x_begin; x <= x_end; x++) {
+			int xb = rotate_coord(xx, prm.scale_x);
+			int yb = rotate_coord(yy, prm.scale_y);
 
-					const byte *data_ptr = data + size.x * 4 * yb + xb * 4;
+			if (mode & GR_FLIP_HORIZONTAL)
+				xb = size.x - xb - 1;
+			if (mode & GR_FLIP_VERTICAL)
+				yb = size.y - yb - 1;
 
-					uint32 a = data_ptr[3];
-					if (a != 255) {
-						a = mask_alpha + ((a * (255 - mask_alpha)) >> 8);
+			const byte *data_ptr = data + (size.x * yb + xb) * psx;
 
-						uint32 r = (mr * (255 - a)) >> 8;
-						uint32 g = (mg * (255 - a)) >> 8;
-						uint32 b = (mb * (255 - a)) >> 8;
+			if (has_alpha) {
+				uint32 a = data_ptr[3];
+				if (a != 255) {
+					a = mask_alpha + ((a * (255 - mask_alpha)) >> 8);
 
-						uint32 cl = make_rgb565u(r, g, b);
+					uint32 r = (mr * (255 - a)) >> 8;
+					uint32 g = (mg * (255 - a)) >> 8;
+					uint32 b = (mb * (255 - a)) >> 8;
 
-						*screen_ptr = alpha_blend_565(cl, *screen_ptr, a);
-					}
+					*screen_ptr = alpha_blend_565(make_rgb565u(r, g, b), *screen_ptr, a);
 				}
+			} else if (data_ptr[0] || data_ptr[1] || data_ptr[2])
+				*screen_ptr = alpha_blend_565(mcl, *screen_ptr, mask_alpha);
 
-				xx += cos_a;
-				yy -= sin_a;
+			xx += prm.cos_a;
+			yy -= prm.sin_a;
 
-				screen_ptr++;
-			}
+			screen_ptr++;
 		}
-	} else {
-		byte mr, mg, mb;
-		split_rgb565u(mask_color, mr, mg, mb);
+	}
+}
 
-		mr = (mr * (255 - mask_alpha)) >> 8;
-		mg = (mg * (255 - mask_alpha)) >> 8;
-		mb = (mb * (255 - mask_alpha)) >> 8;
+void grDispatcher::putSpr_rot(const Vect2i &pos, const Vect2i &size, const byte *data, bool has_alpha, int mode, float angle) {
+	RotateParams prm;
+	if (!rotate_setup(pos, size, angle, true, prm))
+		return;
 
-		for (int y = 0; y <= sy; y++) {
-			uint16 *screen_ptr = (uint16 *)(_screenBuf + _yTable[y + y0] + x0 * 2);
+	putSpr_rot_spans(prm, size, data, has_alpha, mode);
+}
 
-			int xx = (x0 - xc) * cos_a + (y + y0 - yc) * sin_a + scaled_size.x / 2 + (1 << (F_PREC - 1));
-			int yy = (y + y0 - yc) * cos_a - (x0 - xc) * sin_a + scaled_size.y / 2 + (1 << (F_PREC - 1));
+void grDispatcher::putSpr_rot(const Vect2i &pos, const Vect2i &size, const byte *data, bool has_alpha, int mode, float angle, const Vect2f &scale) {
+	RotateParams prm;
+	if (!rotate_setup(pos, size, angle, scale, prm))
+		return;
 
-			for (int x = 0; x <= sx; x++) {
-				int xb = xx / iscale.x;
-				int yb = yy / iscale.y;
+	putSpr_rot_spans(prm, size, data, has_alpha, mode);
+}
 
-				if (xb >= 0 && xb < size.x && yb >= 0 && yb < size.y) {
-					if (mode & GR_FLIP_HORIZONTAL)
-						xb = size.x - xb - 1;
-					if (mode & GR_FLIP_VERTICAL)
-						yb = size.y - yb - 1;
+void grDispatcher::putSprMask_rot(const Vect2i &pos, const Vect2i &size, const byte *data, bool has_alpha, uint32 mask_color, int mask_alpha, int mode, float angle) {
+	RotateParams prm;
+	if (!rotate_setup(pos, size, angle, false, prm))
+		return;
 
-					const byte *data_ptr = data + size.x * 3 * yb + xb * 3;
-					*screen_ptr = make_rgb565u(data_ptr[2], data_ptr[1], data_ptr[0]);
-				}
+	putSprMask_rot_spans(prm, size, data, has_alpha, mask_color, mask_alpha, mode);
+}
 
-				xx += cos_a;
-				yy -= sin_a;
+void grDispatcher::putSprMask_rot(const Vect2i &pos, const Vect2i &size, const byte *data, bool has_alpha, uint32 mask_color, int mask_alpha, int mode, float angle, const Vect2f &scale) {
+	RotateParams prm;
+	if (!rotate_setup(pos, size, angle, scale, prm))
+		return;
 
-				screen_ptr++;
-			}
-		}
-	}
+	putSprMask_rot_spans(prm, size, data, has_alpha, mask_color, mask_alpha, mode);
 }
 
-void grDispatcher::putSpr(int x, int y, int sx, int sy, const byte *p, int mode, int spriteFormat) {
+template<class Pixel>
+void grDispatcher::putSpr_impl(int x, int y, int sx, int sy, const byte *p, int mode, int spriteFormat) {
+	typedef typename Pixel::pixel_t pixel_t;
+
 	debugC(2, kDebugGraphics, "grDispatcher::putSpr(%d, %d, %d, %d, %d)", x, y, sx, sy, spriteFormat);
 
 	int px = 0;
@@ -621,12 +533,12 @@ void grDispatcher::putSpr(int x, int y, int sx, int sy, const byte *p, int mode,
 		const byte *data_ptr = p + py * sx;
 
 		for (int i = 0; i < psy; i++) {
-			uint16 *scr_buf = reinterpret_cast<uint16 *>(_screenBuf->getBasePtr(x, y));
+			pixel_t *scr_buf = reinterpret_cast<pixel_t *>(_screenBuf->getBasePtr(x, y));
 			const byte *data_line = data_ptr + px;
 
 			for (int j = 0; j < psx; j++) {
 				if (*data_line)
-					*scr_buf = make_rgb565u(data_line[2], data_line[1], data_line[0]);
+					*scr_buf = Pixel::make(data_line[2], data_line[1], data_line[0]);
 				scr_buf += dx;
 				data_line += 3;
 			}
@@ -634,19 +546,19 @@ void grDispatcher::putSpr(int x, int y, int sx, int sy, const byte *p, int mode,
 			data_ptr += sx;
 			y += dy;
 		}
-	} else if (spriteFormat == GR_RGB565) {
+	} else if (spriteFormat == GR_RGB565 || spriteFormat == GR_ARGB1555) {
 		sx *= 2;
 		px *= 2;
 
 		const byte *data_ptr = p + py * sx;
 
 		for (int i = 0; i < psy; i++) {
-			uint16 *scr_buf = reinterpret_cast<uint16 *>(_screenBuf->getBasePtr(x, y));
+			pixel_t *scr_buf = reinterpret_cast<pixel_t *>(_screenBuf->getBasePtr(x, y));
 			const byte *data_line = data_ptr + px;
 
 			for (int j = 0; j < psx; j++) {
 				if (*data_line)
-					*scr_buf = *(const uint16 *)data_line;
+					*scr_buf = *(const pixel_t *)data_line;
 				scr_buf += dx;
 				data_line += 2;
 			}
@@ -994,7 +906,10 @@ void grDispatcher::putChar(int x, int y, uint32 color, int font_sx, int font_sy,
 	return;
 }
 
-void grDispatcher::putSprMask(int x, int y, int sx, int sy, const byte *p, uint32 mask_color, int mask_alpha, int mode) {
+template<class Pixel>
+void grDispatcher::putSprMask_impl(int x, int y, int sx, int sy, const byte *p, uint32 mask_color, int mask_alpha, int mode) {
+	typedef typename Pixel::pixel_t pixel_t;
+
 	int px = 0;
 	int py = 0;
 
@@ -1025,22 +940,22 @@ void grDispatcher::putSprMask(int x, int y, int sx, int sy, const byte *p, uint3
 	const byte *data_ptr = p + py * sx + px;
 
 	byte mr, mg, mb;
-	split_rgb565u(mask_color, mr, mg, mb);
+	Pixel::split(mask_color, mr, mg, mb);
 
 	mr = (mr * (255 - mask_alpha)) >> 8;
 	mg = (mg * (255 - mask_alpha)) >> 8;
 	mb = (mb * (255 - mask_alpha)) >> 8;
 
-	uint32 mcl = make_rgb565u(mr, mg, mb);
+	uint32 mcl = Pixel::make(mr, mg, mb);
 
 	warning("STUB: grDispatcher::putSprMask");
 	for (int i = 0; i < psy; i++) {
-		uint16 *scr_buf = (uint16 *)(_screenBuf->getBasePtr(x, y));
+		pixel_t *scr_buf = (pixel_t *)(_screenBuf->getBasePtr(x, y));
 		const byte *data_line = data_ptr;
 
 		for (int j = 0; j < psx; j++) {
 			if (data_line[0] || data_line[1] || data_line[2])
-				*scr_buf = alpha_blend_565(mcl, *scr_buf, mask_alpha);
+				*scr_buf = Pixel::blend(mcl, *scr_buf, mask_alpha);
 			scr_buf += dx;
 			data_line += 3;
 		}
@@ -1050,7 +965,10 @@ void grDispatcher::putSprMask(int x, int y, int sx, int sy, const byte *p, uint3
 	}
 }
 
-void grDispatcher::putSprMask(int x, int y, int sx, int sy, const byte *p, uint32 mask_color, int mask_alpha, int mode, float scale) {
+template<class Pixel>
+void grDispatcher::putSprMask_impl(int x, int y, int sx, int sy, const byte *p, uint32 mask_color, int mask_alpha, int mode, float scale) {
+	typedef typename Pixel::pixel_t pixel_t;
+
 	int sx_dest = round(float(sx) * scale);
 	int sy_dest = round(float(sy) * scale);
 
@@ -1058,59 +976,64 @@ void grDispatcher::putSprMask(int x, int y, int sx, int sy, const byte *p, uint3
 
 	int dx = (sx << 16) / sx_dest;
 	int dy = (sy << 16) / sy_dest;
-	int fx = (1 << 15);
-	int fy = (1 << 15);
 
 	int x0 = 0;
-	int x1 = sx_dest;
 	int ix = 1;
 
 	int y0 = 0;
-	int y1 = sy_dest;
 	int iy = 1;
 
 	if (mode & GR_FLIP_VERTICAL) {
-		y0 = sy_dest,
-		y1 = 0;
+		y0 = sy_dest;
 		iy = -1;
 	}
 
 	if (mode & GR_FLIP_HORIZONTAL) {
-		x0 = sx_dest,
-		x1 = 0;
+		x0 = sx_dest;
 		ix = -1;
 	}
 
+	int count_x = sx_dest;
+	int count_y = sy_dest;
+
+	int kx0, kx1, ky0, ky1;
+	if (!clip_scaled(x + x0, ix, count_x, _clipCoords[GR_LEFT], _clipCoords[GR_RIGHT], kx0, kx1)) return;
+	if (!clip_scaled(y + y0, iy, count_y, _clipCoords[GR_TOP], _clipCoords[GR_BOTTOM], ky0, ky1)) return;
+
+	x += x0 + kx0 * ix;
+	count_x = kx1 - kx0;
+
 	byte mr, mg, mb;
-	split_rgb565u(mask_color, mr, mg, mb);
+	Pixel::split(mask_color, mr, mg, mb);
 
 	mr = (mr * (255 - mask_alpha)) >> 8;
 	mg = (mg * (255 - mask_alpha)) >> 8;
 	mb = (mb * (255 - mask_alpha)) >> 8;
 
-	uint32 mcl = make_rgb565u(mr, mg, mb);
+	uint32 mcl = Pixel::make(mr, mg, mb);
 
-	sx *= 3;
+	const int *columns = scale_columns(kx0, kx1, dx, 3);
 
-	for (int i = y0; i != y1; i += iy) {
+	sx *= 3;
+	int fy = (1 << 15) + ky0 * dy;
+	for (int i = ky0; i < ky1; i++) {
 		const byte *line_src = p + ((fy >> 16) * sx);
-
 		fy += dy;
-		fx = (1 << 15);
 
-		for (int j = x0; j != x1; j += ix) {
-			const byte *src_data = line_src + (fx >> 16) * 3;
-			if (src_data[0] || src_data[1] || src_data[2]) {
-				uint16 scl;
-				getPixel(x + j, y + i, scl);
-				setPixel(x + j, y + i, alpha_blend_565(mcl, scl, mask_alpha));
-			}
-			fx += dx;
+		pixel_t *scr_buf = reinterpret_cast<pixel_t *>(_screenBuf->getBasePtr(x, y + y0 + i * iy));
+		for (int j = 0; j < count_x; j++) {
+			const byte *src_data = line_src + columns[j];
+			if (src_data[0] || src_data[1] || src_data[2])
+				*scr_buf = Pixel::blend(mcl, *scr_buf, mask_alpha);
+			scr_buf += ix;
 		}
 	}
 }
 
-void grDispatcher::putSprMask_a(int x, int y, int sx, int sy, const byte *p, uint32 mask_color, int mask_alpha, int mode) {
+template<class Pixel>
+void grDispatcher::putSprMask_a_impl(int x, int y, int sx, int sy, const byte *p, uint32 mask_color, int mask_alpha, int mode) {
+	typedef typename Pixel::pixel_t pixel_t;
+
 	int px = 0;
 	int py = 0;
 
@@ -1140,11 +1063,11 @@ void grDispatcher::putSprMask_a(int x, int y, int sx, int sy, const byte *p, uin
 	const byte *data_ptr = p + py * sx + px;
 
 	byte mr, mg, mb;
-	split_rgb565u(mask_color, mr, mg, mb);
+	Pixel::split(mask_color, mr, mg, mb);
 
 	warning("STUB: grDispatcher::putSprMask_a");
 	for (int i = 0; i < psy; i++) {
-		uint16 *scr_buf = (uint16 *)(_screenBuf->getBasePtr(x, y));
+		pixel_t *scr_buf = (pixel_t *)(_screenBuf->getBasePtr(x, y));
 		const byte *data_line = data_ptr;
 
 		for (int j = 0; j < psx; j++) {
@@ -1157,9 +1080,9 @@ void grDispatcher::putSprMask_a(int x, int y, int sx, int sy, const byte *p, uin
 				uint32 g = (mg * (255 - a)) >> 8;
 				uint32 b = (mb * (255 - a)) >> 8;
 
-				uint32 cl = make_rgb565u(r, g, b);
+				uint32 cl = Pixel::make(r, g, b);
 
-				*scr_buf = alpha_blend_565(cl, *scr_buf, a);
+				*scr_buf = Pixel::blend(cl, *scr_buf, a);
 			}
 			scr_buf += dx;
 			data_line += 4;
@@ -1169,70 +1092,104 @@ void grDispatcher::putSprMask_a(int x, int y, int sx, int sy, const byte *p, uin
 	}
 }
 
-void grDispatcher::putSprMask_a(int x, int y, int sx, int sy, const byte *p, uint32 mask_color, int mask_alpha, int mode, float scale) {
-	int i, j, sx_dest, sy_dest;
+template<class Pixel>
+void grDispatcher::putSprMask_a_impl(int x, int y, int sx, int sy, const byte *p, uint32 mask_color, int mask_alpha, int mode, float scale) {
+	typedef typename Pixel::pixel_t pixel_t;
 
-	sx_dest = round(float(sx) * scale);
-	sy_dest = round(float(sy) * scale);
+	int sx_dest = round(float(sx) * scale);
+	int sy_dest = round(float(sy) * scale);
 
 	if (!sx_dest || !sy_dest) return;
 
 	int dx = (sx << 16) / sx_dest;
 	int dy = (sy << 16) / sy_dest;
-	int fx = (1 << 15);
-	int fy = (1 << 15);
 
 	int x0 = 0;
-	int x1 = sx_dest;
 	int ix = 1;
 
 	int y0 = 0;
-	int y1 = sy_dest;
 	int iy = 1;
 
 	if (mode & GR_FLIP_VERTICAL) {
-		y0 = sy_dest,
-		y1 = 0;
+		y0 = sy_dest;
 		iy = -1;
 	}
 
 	if (mode & GR_FLIP_HORIZONTAL) {
-		x0 = sx_dest,
-		x1 = 0;
+		x0 = sx_dest;
 		ix = -1;
 	}
 
-	sx <<= 1;
+	int count_x = sx_dest;
+	int count_y = sy_dest;
+
+	int kx0, kx1, ky0, ky1;
+	if (!clip_scaled(x + x0, ix, count_x, _clipCoords[GR_LEFT], _clipCoords[GR_RIGHT], kx0, kx1)) return;
+	if (!clip_scaled(y + y0, iy, count_y, _clipCoords[GR_TOP], _clipCoords[GR_BOTTOM], ky0, ky1)) return;
+
+	x += x0 + kx0 * ix;
+	count_x = kx1 - kx0;
+
 	byte mr, mg, mb;
-	split_rgb565u(mask_color, mr, mg, mb);
+	Pixel::split(mask_color, mr, mg, mb);
 
-	for (i = y0; i != y1; i += iy) {
-		const byte *line_src = p + ((fy >> 16) * sx);
+	const int *columns = scale_columns(kx0, kx1, dx, 4);
 
+	sx *= 4;
+	int fy = (1 << 15) + ky0 * dy;
+	for (int i = ky0; i < ky1; i++) {
+		const byte *line_src = p + ((fy >> 16) * sx);
 		fy += dy;
-		fx = (1 << 15);
 
-		for (j = x0; j != x1; j += ix) {
-			const byte *src_data = line_src + (fx >> 16) * 4;
+		pixel_t *scr_buf = reinterpret_cast<pixel_t *>(_screenBuf->getBasePtr(x, y + y0 + i * iy));
+		for (int j = 0; j < count_x; j++) {
+			const byte *src_data = line_src + columns[j];
 			uint32 a = src_data[3];
 
-			if (a != 255 && clipCheck(x + j, y + i)) {
-				uint16 sc;
-				getPixel(x + j, y + i, sc);
-
+			if (a != 255) {
 				a = mask_alpha + ((a * (255 - mask_alpha)) >> 8);
 
 				uint32 r = (mr * (255 - a)) >> 8;
 				uint32 g = (mg * (255 - a)) >> 8;
 				uint32 b = (mb * (255 - a)) >> 8;
 
-				uint32 cl = make_rgb565u(r, g, b);
-
-				setPixel(x + j, y + i, alpha_blend_565(cl, sc, a));
+				*scr_buf = Pixel::blend(Pixel::make(r, g, b), *scr_buf, a);
 			}
-			fx += dx;
+			scr_buf += ix;
 		}
 	}
 }
 
+void grDispatcher::putSpr_a(int x, int y, int sx, int sy, const byte *p, int mode, float scale) {
+	putSpr_a_impl<grPixelRGB565>(x, y, sx, sy, p, mode, scale);
+}
+
+void grDispatcher::putSpr(int x, int y, int sx, int sy, const byte *p, int mode, int spriteFormat, float scale) {
+	putSpr_impl<grPixelRGB565>(x, y, sx, sy, p, mode, spriteFormat, scale);
+}
+
+void grDispatcher::putSpr_a(int x, int y, int sx, int sy, const byte *p, int mode) {
+	putSpr_a_impl<grPixelRGB565>(x, y, sx, sy, p, mode);
+}
+
+void grDispatcher::putSpr(int x, int y, int sx, int sy, const byte *p, int mode, int spriteFormat) {
+	putSpr_impl<grPixelRGB565>(x, y, sx, sy, p, mode, spriteFormat);
+}
+
+void grDispatcher::putSprMask(int x, int y, int sx, int sy, const byte *p, uint32 mask_color, int mask_alpha, int mode) {
+	putSprMask_impl<grPixelRGB565>(x, y, sx, sy, p, mask_color, mask_alpha, mode);
+}
+
+void grDispatcher::putSprMask(int x, int y, int sx, int sy, const byte *p, uint32 mask_color, int mask_alpha, int mode, float scale) {
+	putSprMask_impl<grPixelRGB565>(x, y, sx, sy, p, mask_color, mask_alpha, mode, scale);
+}
+
+void grDispatcher::putSprMask_a(int x, int y, int sx, int sy, const byte *p, uint32 mask_color, int mask_alpha, int mode) {
+	putSprMask_a_impl<grPixelRGB565>(x, y, sx, sy, p, mask_color, mask_alpha, mode);
+}
+
+void grDispatcher::putSprMask_a(int x, int y, int sx, int sy, const byte *p, uint32 mask_color, int mask_alpha, int mode, float scale) {
+	putSprMask_a_impl<grPixelRGB565>(x, y, sx, sy, p, mask_color, mask_alpha, mode, scale);
+}
+
 } // namespace QDEngine
@@ -25,12 +25,16 @@
 #include "qdengine/qdengine.h"
 #include "qdengine/qd_fwd.h"
 #include "qdengine/system/graphics/gr_dispatcher.h"
+#include "qdengine/system/graphics/gr_pixel_format.h"
 #include "qdengine/system/graphics/rle_compress.h"
 
 
 namespace QDEngine {
 
-void grDispatcher::putSpr_rle(int x, int y, int sx, int sy, const class rleBuffer *p, int mode, bool alpha_flag) {
+template<class Pixel>
+void grDispatcher::putSpr_rle_impl(int x, int y, int sx, int sy, const rleBuffer *p, int mode, bool alpha_flag) {
+	typedef typename Pixel::pixel_t pixel_t;
+
 	debugC(2, kDebugGraphics, "grDispatcher::putSpr_rle(%d, %d, %d, %d)", x, y, sx, sy);
 
 	int px = 0;
@@ -57,37 +61,81 @@ void grDispatcher::putSpr_rle(int x, int y, int sx, int sy, const class rleBuffe
 	} else
 		dy = 1;
 
-	for (int i = 0; i < psy; i++) {
-		uint16 *scr_buf = reinterpret_cast<uint16 *>(_screenBuf->getBasePtr(x, y));
+	if (Pixel::native_rle && p->is_native()) {
+		for (int i = 0; i < psy; i++) {
+			pixel_t *scr_buf = reinterpret_cast<pixel_t *>(_screenBuf->getBasePtr(x, y));
 
-		const char *rle_header = p->header_ptr(py + i);
-		const uint32 *rle_data = p->data_ptr(py + i);
+			int offset;
+			const uint16 *rle_ptr = p->native_seek(px, py + i, offset);
+			offset = px - offset;
 
-		int j = 0;
-		char count = 0;
-		while (j < px) {
-			count = *rle_header++;
-			if (count > 0) {
-				if (count + j <= px) {
-					j += count;
-					rle_data++;
-					count = 0;
-				} else {
-					count -= px - j;
-					j = px;
-				}
-			} else {
-				if (j - count <= px) {
-					j -= count;
-					rle_data -= count;
-					count = 0;
-				} else {
-					count += px - j;
-					rle_data += px - j;
-					j = px;
+			int j = px;
+			while (j < psx) {
+				uint16 run = *rle_ptr++;
+				int count = MIN<int>((run & rleBuffer::NATIVE_LENGTH_MASK) - offset, psx - j);
+
+				switch (run & (rleBuffer::NATIVE_KIND_MASK | rleBuffer::NATIVE_REPEAT)) {
+				case rleBuffer::NATIVE_OPAQUE | rleBuffer::NATIVE_REPEAT: {
+					uint16 cl = rle_ptr[0];
+					for (int k = 0; k < count; k++)
+						scr_buf[k * dx] = cl;
+					}
+					break;
+				case rleBuffer::NATIVE_OPAQUE:
+					if (dx > 0) {
+						memcpy(scr_buf, rle_ptr + offset, count * sizeof(uint16));
+					} else {
+						const uint16 *data_ptr = rle_ptr + offset;
+						for (int k = 0; k < count; k++)
+							scr_buf[-k] = data_ptr[k];
+					}
+					break;
+				case rleBuffer::NATIVE_ALPHA | rleBuffer::NATIVE_REPEAT: {
+					uint16 cl = rle_ptr[0];
+					uint32 a = rle_ptr[1];
+					for (int k = 0; k < count; k++)
+						scr_buf[k * dx] = Pixel::blend(cl, scr_buf[k * dx], a);
+					}
+					break;
+				case rleBuffer::NATIVE_ALPHA: {
+					const uint16 *data_ptr = rle_ptr + offset * 2;
+					for (int k = 0; k < count; k++) {
+						scr_buf[k * dx] = Pixel::blend(data_ptr[0], scr_buf[k * dx], data_ptr[1]);
+						data_ptr += 2;
+					}
+					}
+					break;
+				default:
+					break;
 				}
+
+				scr_buf += dx * count;
+				rle_ptr += rleBuffer::native_run_data_size(run);
+				j += count;
+				offset = 0;
 			}
+			y += dy;
+		}
+		return;
+	}
+
+	for (int i = 0; i < psy; i++) {
+		pixel_t *scr_buf = reinterpret_cast<pixel_t *>(_screenBuf->getBasePtr(x, y));
+
+		const char *rle_header;
+		const uint32 *rle_data;
+
+		int j;
+		p->seek(px, py + i, rle_header, rle_data, j);
+
+		char count = *rle_header++;
+		if (count > 0) {
+			count -= px - j;
+		} else {
+			count += px - j;
+			rle_data += px - j;
 		}
+		j = px;
 
 		if (!alpha_flag) {
 			while (j < psx) {
@@ -95,7 +143,7 @@ void grDispatcher::putSpr_rle(int x, int y, int sx, int sy, const class rleBuffe
 					while (count && j < psx) {
 						if (*rle_data) {
 							const byte *rle_buf = (const byte *)rle_data;
-							uint32 cl = make_rgb565u(rle_buf[2], rle_buf[1], rle_buf[0]);
+							uint32 cl = Pixel::make(rle_buf[2], rle_buf[1], rle_buf[0]);
 							*scr_buf = cl;
 						}
 						scr_buf += dx;
@@ -109,7 +157,7 @@ void grDispatcher::putSpr_rle(int x, int y, int sx, int sy, const class rleBuffe
 						while (count && j < psx) {
 							if (*rle_data) {
 								const byte *rle_buf = (const byte *)rle_data;
-								uint32 cl = make_rgb565u(rle_buf[2], rle_buf[1], rle_buf[0]);
+								uint32 cl = Pixel::make(rle_buf[2], rle_buf[1], rle_buf[0]);
 								*scr_buf = cl;
 							}
 							scr_buf += dx;
@@ -124,10 +172,11 @@ void grDispatcher::putSpr_rle(int x, int y, int sx, int sy, const class rleBuffe
 		} else {
 			while (j < psx) {
 				if (count > 0) {
+					const byte *rle_buf = (const byte *)rle_data;
+					uint32 a = rle_buf[3];
+					uint32 cl = Pixel::make(rle_buf[2], rle_buf[1], rle_buf[0]);
 					while (count && j < psx) {
-						const byte *rle_buf = (const byte *)rle_data;
-						uint32 a = rle_buf[3];
-						*scr_buf = alpha_blend_565(make_rgb565u(rle_buf[2], rle_buf[1], rle_buf[0]), *scr_buf, a);
+						*scr_buf = Pixel::blend(cl, *scr_buf, a);
 						scr_buf += dx;
 						count--;
 						j++;
@@ -136,15 +185,11 @@ void grDispatcher::putSpr_rle(int x, int y, int sx, int sy, const class rleBuffe
 				} else {
 					if (count < 0) {
 						count = -count;
-						while (count && j < psx) {
-							const byte *rle_buf = (const byte *)rle_data;
-							uint32 a = rle_buf[3];
-							*scr_buf = alpha_blend_565(make_rgb565u(rle_buf[2], rle_buf[1], rle_buf[0]), *scr_buf, a);
-							scr_buf += dx;
-							rle_data++;
-							count--;
-							j++;
-						}
+						int run = MIN<int>(count, psx - j);
+						Pixel::alphaLine(scr_buf, (const byte *)rle_data, run, dx);
+						scr_buf += dx * run;
+						rle_data += run;
+						j += run;
 					}
 				}
 				count = *rle_header++;
@@ -154,7 +199,10 @@ void grDispatcher::putSpr_rle(int x, int y, int sx, int sy, const class rleBuffe
 	}
 }
 
-void grDispatcher::putSpr_rle(int x, int y, int sx, int sy, const class rleBuffer *p, int mode, float scale, bool alpha_flag) {
+template<class Pixel>
+void grDispatcher::putSpr_rle_impl(int x, int y, int sx, int sy, const rleBuffer *p, int mode, float scale, bool alpha_flag) {
+	typedef typename Pixel::pixel_t pixel_t;
+
 	debugC(2, kDebugGraphics, "grDispatcher::putSpr_rle(%d, %d, %d, %d, scale=%f)", x, y, sx, sy, scale);
 
 	int sx_dest = round(float(sx) * scale);
@@ -164,77 +212,78 @@ void grDispatcher::putSpr_rle(int x, int y, int sx, int sy, const class rleBuffe
 
 	int dx = (sx << 16) / sx_dest;
 	int dy = (sy << 16) / sy_dest;
-	int fx = (1 << 15);
-	int fy = (1 << 15);
 
 	int x0 = 0;
-	int x1 = sx_dest - 1;
 	int ix = 1;
 
 	int y0 = 0;
-	int y1 = sy_dest - 1;
 	int iy = 1;
 
 	if (mode & GR_FLIP_VERTICAL) {
-		y0 = sy_dest - 1,
-		y1 = 0;
+		y0 = sy_dest - 1;
 		iy = -1;
 	}
 
 	if (mode & GR_FLIP_HORIZONTAL) {
-		x0 = sx_dest - 1,
-		x1 = 0;
+		x0 = sx_dest - 1;
 		ix = -1;
 	}
-	if (!alpha_flag) {
-		const byte *line_src = rleBuffer::get_buffer(0);
-		for (int i = y0; i != y1; i += iy) {
-			p->decode_line(fy >> 16);
 
-			fy += dy;
-			fx = (1 << 15);
+	int count_x = sx_dest - 1;
+	int count_y = sy_dest - 1;
 
-			for (int j = x0; j != x1; j += ix) {
-				if (clipCheck(x + j, y + i)) {
-					const byte *src_data = line_src + (fx >> 16) * 3;
-					if (src_data[0] || src_data[1] || src_data[2])
-						setPixelFast(x + j, y + i, make_rgb565u(src_data[2], src_data[1], src_data[0]));
-				}
-				fx += dx;
-			}
-		}
-	} else {
-		const byte *line_src = rleBuffer::get_buffer(0);
-		for (int i = y0; i != y1; i += iy) {
-			p->decode_line(fy >> 16);
+	int kx0, kx1, ky0, ky1;
+	if (!clip_scaled(x + x0, ix, count_x, _clipCoords[GR_LEFT], _clipCoords[GR_RIGHT], kx0, kx1)) return;
+	if (!clip_scaled(y + y0, iy, count_y, _clipCoords[GR_TOP], _clipCoords[GR_BOTTOM], ky0, ky1)) return;
 
-			fy += dy;
-			fx = (1 << 15);
+	x += x0 + kx0 * ix;
+	count_x = kx1 - kx0;
 
-			for (int j = x0; j != x1; j += ix) {
-				if (clipCheck(x + j, y + i)) {
-					const byte *src_data = line_src + ((fx >> 16) << 2);
+	const int *columns = scale_columns(kx0, kx1, dx, 4);
+	const byte *line_src = rleBuffer::get_buffer(0);
 
-					uint32 a = src_data[3];
-					if (a != 255) {
-						uint32 cl = make_rgb565u(src_data[2], src_data[1], src_data[0]);
+	int fy = (1 << 15) + ky0 * dy;
+	int src_y = -1;
+	for (int i = ky0; i < ky1; i++) {
+		// при увеличении одна исходная строка выводится несколько раз подряд
+		if (src_y != (fy >> 16)) {
+			src_y = fy >> 16;
+			p->decode_line(src_y);
+		}
+		fy += dy;
 
-						if (a) {
-							uint16 scl;
-							getPixel(x + j, y + i, scl);
+		pixel_t *scr_buf = reinterpret_cast<pixel_t *>(_screenBuf->getBasePtr(x, y + y0 + i * iy));
 
-							setPixelFast(x + j, y + i, alpha_blend_565(cl, scl, a));
-						} else
-							setPixelFast(x + j, y + i, cl);
-					}
+		if (!alpha_flag) {
+			for (int j = 0; j < count_x; j++) {
+				const byte *src_data = line_src + columns[j];
+				if (src_data[0] || src_data[1] || src_data[2])
+					*scr_buf = Pixel::make(src_data[2], src_data[1], src_data[0]);
+				scr_buf += ix;
+			}
+		} else {
+			for (int j = 0; j < count_x; j++) {
+				const byte *src_data = line_src + columns[j];
+
+				uint32 a = src_data[3];
+				if (a != 255) {
+					uint32 cl = Pixel::make(src_data[2], src_data[1], src_data[0]);
+
+					if (a)
+						*scr_buf = Pixel::blend(cl, *scr_buf, a);
+					else
+						*scr_buf = cl;
 				}
-				fx += dx;
+				scr_buf += ix;
 			}
 		}
 	}
 }
 
-void grDispatcher::putSprMask_rle(int x, int y, int sx, int sy, const rleBuffer *p, uint32 mask_color, int mask_alpha, int mode, bool alpha_flag) {
+template<class Pixel>
+void grDispatcher::putSprMask_rle_impl(int x, int y, int sx, int sy, const rleBuffer *p, uint32 mask_color, int mask_alpha, int mode, bool alpha_flag) {
+	typedef typename Pixel::pixel_t pixel_t;
+
 	debugC(2, kDebugGraphics, "grDispatcher::putSprMask_rle(%d, %d, %d, %d)", x, y, sx, sy);
 
 	int px = 0;
@@ -265,45 +314,91 @@ void grDispatcher::putSprMask_rle(int x, int y, int sx, int sy, const rleBuffer
 		dy = 1;
 
 	warning("STUB: grDispatcher::putSprMask_rle");
-	for (int i = 0; i < psy; i++) {
-		uint16 *scr_buf = reinterpret_cast<uint16 *>(_screenBuf->getBasePtr(x, y));
 
-		const char *rle_header = p->header_ptr(py + i);
-		const uint32 *rle_data = p->data_ptr(py + i);
+	if (Pixel::native_rle && p->is_native()) {
+		for (int i = 0; i < psy; i++) {
+			pixel_t *scr_buf = reinterpret_cast<pixel_t *>(_screenBuf->getBasePtr(x, y));
 
-		int j = 0;
-		char count = 0;
-		while (j < px) {
-			count = *rle_header++;
-			if (count > 0) {
-				if (count + j <= px) {
-					j += count;
-					rle_data++;
-					count = 0;
-				} else {
-					count -= px - j;
-					j = px;
-				}
-			} else {
-				if (j - count <= px) {
-					j -= count;
-					rle_data -= count;
-					count = 0;
-				} else {
-					count += px - j;
-					rle_data += px - j;
-					j = px;
+			int offset;
+			const uint16 *rle_ptr = p->native_seek(px, py + i, offset);
+			offset = px - offset;
+
+			byte mr, mg, mb;
+			Pixel::split(mask_color, mr, mg, mb);
+
+			mr = (mr * (255 - mask_alpha)) >> 8;
+			mg = (mg * (255 - mask_alpha)) >> 8;
+			mb = (mb * (255 - mask_alpha)) >> 8;
+
+			uint32 cl = Pixel::make(mr, mg, mb);
+
+			int j = px;
+			while (j < psx) {
+				uint16 run = *rle_ptr++;
+				int count = MIN<int>((run & rleBuffer::NATIVE_LENGTH_MASK) - offset, psx - j);
+				uint16 kind = run & rleBuffer::NATIVE_KIND_MASK;
+
+				if (kind != rleBuffer::NATIVE_SKIP) {
+					if (!alpha_flag) {
+						for (int k = 0; k < count; k++)
+							scr_buf[k * dx] = cl;
+					} else {
+						const uint16 *data_ptr = rle_ptr;
+						int step = 0;
+						if (!(run & rleBuffer::NATIVE_REPEAT)) {
+							step = (kind == rleBuffer::NATIVE_ALPHA) ? 2 : 1;
+							data_ptr += offset * step;
+						}
+
+						for (int k = 0; k < count; k++) {
+							uint32 a = (kind == rleBuffer::NATIVE_ALPHA) ? data_ptr[1] : 0;
+							a = mask_alpha + ((a * (255 - mask_alpha)) >> 8);
+
+							uint32 r = (mr * (255 - a)) >> 8;
+							uint32 g = (mg * (255 - a)) >> 8;
+							uint32 b = (mb * (255 - a)) >> 8;
+
+							scr_buf[k * dx] = Pixel::blend(Pixel::make(r, g, b), scr_buf[k * dx], a);
+							data_ptr += step;
+						}
+					}
 				}
+
+				scr_buf += dx * count;
+				rle_ptr += rleBuffer::native_run_data_size(run);
+				j += count;
+				offset = 0;
 			}
+			y += dy;
+		}
+		return;
+	}
+
+	for (int i = 0; i < psy; i++) {
+		pixel_t *scr_buf = reinterpret_cast<pixel_t *>(_screenBuf->getBasePtr(x, y));
+
+		const char *rle_header;
+		const uint32 *rle_data;
+
+		int j;
+		p->seek(px, py + i, rle_header, rle_data, j);
+
+		char count = *rle_header++;
+		if (count > 0) {
+			count -= px - j;
+		} else {
+			count += px - j;
+			rle_data += px - j;
 		}
+		j = px;
 		byte mr, mg, mb;
-		split_rgb565u(mask_color, mr, mg, mb);
+		Pixel::split(mask_color, mr, mg, mb);
 
 		mr = (mr * (255 - mask_alpha)) >> 8;
 		mg = (mg * (255 - mask_alpha)) >> 8;
 		mb = (mb * (255 - mask_alpha)) >> 8;
 
-		uint32 cl = make_rgb565u(mr, mg, mb);
+		uint32 cl = Pixel::make(mr, mg, mb);
 
 		if (!alpha_flag) {
 			while (j < psx) {
@@ -347,8 +442,8 @@ void grDispatcher::putSprMask_rle(int x, int y, int sx, int sy, const rleBuffer
 							uint32 g = (mg * (255 - a)) >> 8;
 							uint32 b = (mb * (255 - a)) >> 8;
 
-							cl = make_rgb565u(r, g, b);
-							*scr_buf = alpha_blend_565(cl, *scr_buf, a);
+							cl = Pixel::make(r, g, b);
+							*scr_buf = Pixel::blend(cl, *scr_buf, a);
 						}
 
 						scr_buf += dx;
@@ -370,8 +465,8 @@ void grDispatcher::putSprMask_rle(int x, int y, int sx, int sy, const rleBuffer
 								uint32 g = (mg * (255 - a)) >> 8;
 								uint32 b = (mb * (255 - a)) >> 8;
 
-								cl = make_rgb565u(r, g, b);
-								*scr_buf = alpha_blend_565(cl, *scr_buf, a);
+								cl = Pixel::make(r, g, b);
+								*scr_buf = Pixel::blend(cl, *scr_buf, a);
 							}
 
 							scr_buf += dx;
@@ -388,7 +483,10 @@ void grDispatcher::putSprMask_rle(int x, int y, int sx, int sy, const rleBuffer
 	}
 }
 
-void grDispatcher::putSprMask_rle(int x, int y, int sx, int sy, const rleBuffer *p, uint32 mask_color, int mask_alpha, int mode, float scale, bool alpha_flag) {
+template<class Pixel>
+void grDispatcher::putSprMask_rle_impl(int x, int y, int sx, int sy, const rleBuffer *p, uint32 mask_color, int mask_alpha, int mode, float scale, bool alpha_flag) {
+	typedef typename Pixel::pixel_t pixel_t;
+
 	debugC(2, kDebugGraphics, "grDispatcher::putSprMask_rle(%d, %d, %d, %d, scale=%f)", x, y, sx, sy, scale);
 
 	int sx_dest = round(float(sx) * scale);
@@ -398,192 +496,142 @@ void grDispatcher::putSprMask_rle(int x, int y, int sx, int sy, const rleBuffer
 
 	int dx = (sx << 16) / sx_dest;
 	int dy = (sy << 16) / sy_dest;
-	int fx = (1 << 15);
-	int fy = (1 << 15);
 
 	int x0 = 0;
-	int x1 = sx_dest - 1;
 	int ix = 1;
 
 	int y0 = 0;
-	int y1 = sy_dest - 1;
 	int iy = 1;
 
 	if (mode & GR_FLIP_VERTICAL) {
-		y0 = sy_dest - 1,
-		y1 = 0;
+		y0 = sy_dest - 1;
 		iy = -1;
 	}
 
 	if (mode & GR_FLIP_HORIZONTAL) {
-		x0 = sx_dest - 1,
-		x1 = 0;
+		x0 = sx_dest - 1;
 		ix = -1;
 	}
-	if (!alpha_flag) {
-		byte mr, mg, mb;
-		split_rgb565u(mask_color, mr, mg, mb);
 
-		mr = (mr * (255 - mask_alpha)) >> 8;
-		mg = (mg * (255 - mask_alpha)) >> 8;
-		mb = (mb * (255 - mask_alpha)) >> 8;
+	int count_x = sx_dest - 1;
+	int count_y = sy_dest - 1;
 
-		uint32 mcl = (_pixel_format == GR_RGB565) ? make_rgb565u(mr, mg, mb) : make_rgb555u(mr, mg, mb);
+	int kx0, kx1, ky0, ky1;
+	if (!clip_scaled(x + x0, ix, count_x, _clipCoords[GR_LEFT], _clipCoords[GR_RIGHT], kx0, kx1)) return;
+	if (!clip_scaled(y + y0, iy, count_y, _clipCoords[GR_TOP], _clipCoords[GR_BOTTOM], ky0, ky1)) return;
 
-		const byte *line_src = rleBuffer::get_buffer(0);
+	x += x0 + kx0 * ix;
+	count_x = kx1 - kx0;
 
-		for (int i = y0; i != y1; i += iy) {
-			p->decode_line(fy >> 16);
+	byte mr, mg, mb;
+	Pixel::split(mask_color, mr, mg, mb);
 
-			fy += dy;
-			fx = (1 << 15);
-
-			for (int j = x0; j != x1; j += ix) {
-				if (clipCheck(x + j, y + i)) {
-					const byte *src_buf = line_src + ((fx >> 16) << 2);
-					if (src_buf[0] || src_buf[1] || src_buf[2]) {
-						uint16 scl;
-						getPixel(x + j, y + i, scl);
-						setPixelFast(x + j, y + i, alpha_blend_565(mcl, scl, mask_alpha));
-					}
-				}
-				fx += dx;
-			}
-		}
-	} else {
-		const byte *line_src = rleBuffer::get_buffer(0);
-		byte mr, mg, mb;
-		split_rgb565u(mask_color, mr, mg, mb);
+	uint32 mcl = 0;
+	if (!alpha_flag) {
+		uint32 r = (mr * (255 - mask_alpha)) >> 8;
+		uint32 g = (mg * (255 - mask_alpha)) >> 8;
+		uint32 b = (mb * (255 - mask_alpha)) >> 8;
 
-		for (int i = y0; i != y1; i += iy) {
-			p->decode_line(fy >> 16);
+		mcl = Pixel::make(r, g, b);
+	}
 
-			fy += dy;
-			fx = (1 << 15);
+	const int *columns = scale_columns(kx0, kx1, dx, 4);
+	const byte *line_src = rleBuffer::get_buffer(0);
 
-			for (int j = x0; j != x1; j += ix) {
-				if (clipCheck(x + j, y + i)) {
-					const byte *src_buf = line_src + ((fx >> 16) << 2);
-					uint32 a = src_buf[3];
-					if (a != 255) {
-						uint16 scl;
-						getPixel(x + j, y + i, scl);
+	int fy = (1 << 15) + ky0 * dy;
+	int src_y = -1;
+	for (int i = ky0; i < ky1; i++) {
+		if (src_y != (fy >> 16)) {
+			src_y = fy >> 16;
+			p->decode_line(src_y);
+		}
+		fy += dy;
 
-						a = mask_alpha + ((a * (255 - mask_alpha)) >> 8);
+		pixel_t *scr_buf = reinterpret_cast<pixel_t *>(_screenBuf->getBasePtr(x, y + y0 + i * iy));
 
-						uint32 r = (mr * (255 - a)) >> 8;
-						uint32 g = (mg * (255 - a)) >> 8;
-						uint32 b = (mb * (255 - a)) >> 8;
+		if (!alpha_flag) {
+			for (int j = 0; j < count_x; j++) {
+				const byte *src_buf = line_src + columns[j];
+				if (src_buf[0] || src_buf[1] || src_buf[2])
+					*scr_buf = Pixel::blend(mcl, *scr_buf, mask_alpha);
+				scr_buf += ix;
+			}
+		} else {
+			for (int j = 0; j < count_x; j++) {
+				const byte *src_buf = line_src + columns[j];
+				uint32 a = src_buf[3];
+				if (a != 255) {
+					a = mask_alpha + ((a * (255 - mask_alpha)) >> 8);
 
-						uint32 cl = make_rgb565u(r, g, b);
+					uint32 r = (mr * (255 - a)) >> 8;
+					uint32 g = (mg * (255 - a)) >> 8;
+					uint32 b = (mb * (255 - a)) >> 8;
 
-						setPixelFast(x + j, y + i, alpha_blend_565(cl, scl, a));
-					}
+					*scr_buf = Pixel::blend(Pixel::make(r, g, b), *scr_buf, a);
 				}
-				fx += dx;
+				scr_buf += ix;
 			}
 		}
-		}
+	}
 }
 
-void grDispatcher::putSpr_rle_rot(const Vect2i &pos, const Vect2i &size, const rleBuffer *data, bool has_alpha, int mode, float angle) {
+const byte *grDispatcher::decode_rot_rows(const RotateParams &prm, const Vect2i &size, const rleBuffer *data, bool has_alpha, int mode) {
+	int row_min, row_max;
+	if (!rotate_rows(prm, size, mode, row_min, row_max))
+		return 0;
+
 	byte *buf = (byte *)temp_buffer(size.x * size.y * 4);
 
-	byte *buf_ptr = buf;
-	for (int i = 0; i < size.y; i++) {
+	for (int i = row_min; i <= row_max; i++) {
+		byte *buf_ptr = buf + i * size.x * 4;
 		data->decode_line(i, buf_ptr);
-		buf_ptr += size.x * 4;
-	}
 
-	if (!has_alpha) {
-		uint32 *p = (uint32 *)buf;
-		buf_ptr = buf + 3;
-		for (int i = 0; i < size.y; i++) {
+		if (!has_alpha) {
+			const uint32 *p = (const uint32 *)buf_ptr;
 			for (int j = 0; j < size.x; j++) {
-				if (!*p++)
-					*buf_ptr = 255;
-
-				buf_ptr += 4;
+				if (!p[j])
+					buf_ptr[j * 4 + 3] = 255;
 			}
 		}
 	}
 
-	putSpr_rot(pos, size, buf, true, mode, angle);
+	return buf;
 }
 
-void grDispatcher::putSpr_rle_rot(const Vect2i &pos, const Vect2i &size, const rleBuffer *data, bool has_alpha, int mode, float angle, const Vect2f &scale) {
-	byte *buf = (byte *)temp_buffer(size.x * size.y * 4);
-
-	byte *buf_ptr = buf;
-	for (int i = 0; i < size.y; i++) {
-		data->decode_line(i, buf_ptr);
-		buf_ptr += size.x * 4;
-	}
+void grDispatcher::putSpr_rle_rot(const Vect2i &pos, const Vect2i &size, const rleBuffer *data, bool has_alpha, int mode, float angle) {
+	RotateParams prm;
+	if (!rotate_setup(pos, size, angle, true, prm))
+		return;
 
-	if (!has_alpha) {
-		uint32 *p = (uint32 *)buf;
-		buf_ptr = buf + 3;
-		for (int i = 0; i < size.y; i++) {
-			for (int j = 0; j < size.x; j++) {
-				if (!*p++)
-					*buf_ptr = 255;
+	if (const byte *buf = decode_rot_rows(prm, size, data, has_alpha, mode))
+		putSpr_rot_spans(prm, size, buf, true, mode);
+}
 
-				buf_ptr += 4;
-			}
-		}
-	}
+void grDispatcher::putSpr_rle_rot(const Vect2i &pos, const Vect2i &size, const rleBuffer *data, bool has_alpha, int mode, float angle, const Vect2f &scale) {
+	RotateParams prm;
+	if (!rotate_setup(pos, size, angle, scale, prm))
+		return;
 
-	putSpr_rot(pos, size, buf, true, mode, angle, scale);
+	if (const byte *buf = decode_rot_rows(prm, size, data, has_alpha, mode))
+		putSpr_rot_spans(prm, size, buf, true, mode);
 }
 
 void grDispatcher::putSprMask_rle_rot(const Vect2i &pos, const Vect2i &size, const rleBuffer *data, bool has_alpha, uint32 mask_color, int mask_alpha, int mode, float angle) {
-	byte *buf = (byte *)temp_buffer(size.x * size.y * 4);
-
-	byte *buf_ptr = buf;
-	for (int i = 0; i < size.y; i++) {
-		data->decode_line(i, buf_ptr);
-		buf_ptr += size.x * 4;
-	}
-
-	if (!has_alpha) {
-		uint32 *p = (uint32 *)buf;
-		buf_ptr = buf + 3;
-		for (int i = 0; i < size.y; i++) {
-			for (int j = 0; j < size.x; j++) {
-				if (!*p++)
-					*buf_ptr = 255;
-
-				buf_ptr += 4;
-			}
-		}
-	}
+	RotateParams prm;
+	if (!rotate_setup(pos, size, angle, false, prm))
+		return;
 
-	putSprMask_rot(pos, size, buf, true, mask_color, mask_alpha, mode, angle);
+	if (const byte *buf = decode_rot_rows(prm, size, data, has_alpha, mode))
+		putSprMask_rot_spans(prm, size, buf, true, mask_color, mask_alpha, mode);
 }
 
 void grDispatcher::putSprMask_rle_rot(const Vect2i &pos, const Vect2i &size, const rleBuffer *data, bool has_alpha, uint32 mask_color, int mask_alpha, int mode, float angle, const Vect2f &scale) {
-	byte *buf = (byte *)temp_buffer(size.x * size.y * 4);
-
-	byte *buf_ptr = buf;
-	for (int i = 0; i < size.y; i++) {
-		data->decode_line(i, buf_ptr);
-		buf_ptr += size.x * 4;
-	}
-
-	if (!has_alpha) {
-		uint32 *p = (uint32 *)buf;
-		buf_ptr = buf + 3;
-		for (int i = 0; i < size.y; i++) {
-			for (int j = 0; j < size.x; j++) {
-				if (!*p++)
-					*buf_ptr = 255;
-
-				buf_ptr += 4;
-			}
-		}
-	}
+	RotateParams prm;
+	if (!rotate_setup(pos, size, angle, scale, prm))
+		return;
 
-	putSprMask_rot(pos, size, buf, true, mask_color, mask_alpha, mode, angle, scale);
+	if (const byte *buf = decode_rot_rows(prm, size, data, has_alpha, mode))
+		putSprMask_rot_spans(prm, size, buf, true, mask_color, mask_alpha, mode);
 }
 
 inline bool rle_alpha_b(uint32 pixel) {
@@ -815,4 +863,20 @@ void grDispatcher::drawSprContour(int x, int y, int sx, int sy, const class rleB
 	}
 }
 
+void grDispatcher::putSpr_rle(int x, int y, int sx, int sy, const class rleBuffer *p, int mode, bool alpha_flag) {
+	putSpr_rle_impl<grPixelRGB565>(x, y, sx, sy, p, mode, alpha_flag);
+}
+
+void grDispatcher::putSprMask_rle(int x, int y, int sx, int sy, const rleBuffer *p, uint32 mask_color, int mask_alpha, int mode, bool alpha_flag) {
+	putSprMask_rle_impl<grPixelRGB565>(x, y, sx, sy, p, mask_color, mask_alpha, mode, alpha_flag);
+}
+
+void grDispatcher::putSpr_rle(int x, int y, int sx, int sy, const class rleBuffer *p, int mode, float scale, bool alpha_flag) {
+	putSpr_rle_impl<grPixelRGB565>(x, y, sx, sy, p, mode, scale, alpha_flag);
+}
+
+void grDispatcher::putSprMask_rle(int x, int y, int sx, int sy, const rleBuffer *p, uint32 mask_color, int mask_alpha, int mode, float scale, bool alpha_flag) {
+	putSprMask_rle_impl<grPixelRGB565>(x, y, sx, sy, p, mask_color, mask_alpha, mode, scale, alpha_flag);
+}
+
 } // namespace QDEngine
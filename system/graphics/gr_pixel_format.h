@@ -0,0 +1,71 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef QDENGINE_SYSTEM_GRAPHICS_GR_PIXEL_FORMAT_H
+#define QDENGINE_SYSTEM_GRAPHICS_GR_PIXEL_FORMAT_H
+
+#include "qdengine/system/graphics/gr_dispatcher.h"
+#include "qdengine/system/graphics/gr_blend.h"
+
+namespace QDEngine {
+
+/// Форматы пикселов экрана для шаблонных блиттеров grDispatcher.
+
+/// Блиттер инстанцируется для формата экранной поверхности
+/// (grDispatcher::screen_format()) и вызывается напрямую, так что ни
+/// внутри циклов по пикселам, ни при вызове нет проверок формата.
+/// pixel_t - тип пиксела экрана, make() - цвет из компонент,
+/// blend() - смешивание с экраном как в grDispatcher::alpha_blend_565(),
+/// alphaLine() - вывод строки 32-битного BGRA спрайта с альфой,
+/// fillAlphaLine() - смешивание строки экрана с одним цветом.
+
+struct grPixelRGB565 {
+	typedef uint16 pixel_t;
+
+	/// Данные rleBuffer::convert_native() хранятся в этом формате.
+	static const bool native_rle = true;
+
+	static inline pixel_t make(uint32 r, uint32 g, uint32 b) {
+		return grDispatcher::make_rgb565u(r, g, b);
+	}
+	static inline void split(uint32 col, byte &r, byte &g, byte &b) {
+		grDispatcher::split_rgb565u(col, r, g, b);
+	}
+	static inline pixel_t blend(pixel_t pic_col, pixel_t scr_col, uint32 a) {
+		return grDispatcher::alpha_blend_565(pic_col, scr_col, a);
+	}
+
+	static inline void alphaLine(pixel_t *dst, const byte *src, int count, int dx) {
+		if (dx > 0)
+			(*gr_blend::alphaLine565)(dst, src, count);
+		else
+			(*gr_blend::alphaLine565Reverse)(dst, src, count);
+	}
+
+	static inline void fillAlphaLine(pixel_t *dst, pixel_t col, uint32 a, int count) {
+		(*gr_blend::fillAlphaLine565)(dst, col, a, count);
+	}
+};
+
+} // namespace QDEngine
+
+#endif // QDENGINE_SYSTEM_GRAPHICS_GR_PIXEL_FORMAT_H
@@ -25,6 +25,7 @@
 #include "qdengine/qdengine.h"
 #include "qdengine/system/graphics/gr_dispatcher.h"
 #include "qdengine/system/graphics/gr_tile_animation.h"
+#include "qdengine/system/graphics/gr_tile_cache.h"
 
 
 namespace QDEngine {
@@ -53,6 +54,17 @@ void grTileAnimation::clear() {
 
 	_tileData.clear();
 	TileData(_tileData).swap(_tileData);
+
+	_tileTypes.clear();
+	TileTypes(_tileTypes).swap(_tileTypes);
+
+	_cacheID = grTileCache::newOwnerID();
+
+	clearTileIndex();
+}
+
+void grTileAnimation::setTileCacheSize(uint32 size) {
+	grTileCache::instance().setMemoryLimit(size);
 }
 
 void grTileAnimation::init(int frame_count, const Vect2i &frame_size, bool alpha_flag) {
@@ -71,13 +83,17 @@ void grTileAnimation::init(int frame_count, const Vect2i &frame_size, bool alpha
 	_tileOffsets.push_back(0);
 
 	_tileData.reserve(frame_count * _frameTileSize.x * _frameTileSize.y * GR_TILE_SPRITE_SIZE);
+	_tileTypes.reserve(frame_count * _frameTileSize.x * _frameTileSize.y);
 
 	_frameCount = frame_count;
 }
 
 void grTileAnimation::compact() {
+	clearTileIndex();
+
 	TileOffsets(_tileOffsets).swap(_tileOffsets);
 	TileData(_tileData).swap(_tileData);
+	TileTypes(_tileTypes).swap(_tileTypes);
 	debugC(3, kDebugLog, "Tile animation: %u Kbytes", (_frameIndex.size() + _tileData.size() + _tileOffsets.size()) * 4 / 1024);
 }
 
@@ -114,6 +130,8 @@ bool grTileAnimation::compress(grTileCompressionMethod method) {
 	_tileData.swap(tile_data);
 	_tileOffsets.swap(tile_offsets);
 
+	_cacheID = grTileCache::newOwnerID();
+
 	return true;
 }
 
@@ -124,15 +142,25 @@ grTileSprite grTileAnimation::getTile(int tile_index) const {
 
 	switch (_compression) {
 	case TILE_UNCOMPRESSED:
-		return grTileSprite(&*_tileData.begin() + _tileOffsets[tile_index]);
+		return grTileSprite(&*_tileData.begin() + _tileOffsets[tile_index], tileType(tile_index));
 	default:
-		if (!grTileSprite::uncompress(&*_tileData.begin() + _tileOffsets[tile_index], GR_TILE_SPRITE_SIZE, tile_buf, _compression)) {
-			assert(0 && "Unknown compression algorithm");
-		}
-		return grTileSprite(tile_buf);
+		return grTileSprite(unpackTile(tile_index, tile_buf), tileType(tile_index));
 	}
 }
 
+const uint32 *grTileAnimation::unpackTile(int tile_index, uint32 *buf) const {
+	if (const uint32 *cached_tile = grTileCache::instance().find(_cacheID, tile_index))
+		return cached_tile;
+
+	if (uint32 *cache_buf = grTileCache::instance().insert(_cacheID, tile_index))
+		buf = cache_buf;
+
+	if (!grTileSprite::uncompress(&*_tileData.begin() + _tileOffsets[tile_index], GR_TILE_SPRITE_SIZE, buf, _compression)) {
+		assert(0 && "Unknown compression algorithm");
+	}
+	return buf;
+}
+
 void grTileAnimation::addFrame(const uint32 *frame_data) {
 	TileData tile_vector = TileData(GR_TILE_SPRITE_SIZE, 0);
 	TileData tile_vector2 = TileData(GR_TILE_SPRITE_SIZE * 4, 0);
@@ -142,6 +170,8 @@ void grTileAnimation::addFrame(const uint32 *frame_data) {
 		(*_progressHandler)(percent_done, _progressHandlerContext);
 	}
 
+	clearRotFrame();
+
 	for (int i = 0; i < _frameTileSize.y; i++) {
 		for (int j = 0; j < _frameTileSize.x; j++) {
 			Common::fill(tile_vector.begin(), tile_vector.end(), 0);
@@ -162,15 +192,8 @@ void grTileAnimation::addFrame(const uint32 *frame_data) {
 				tile_ptr += GR_TILE_SPRITE_SIZE_X;
 			}
 
-			int tile_id = -1;
+			int tile_id = findTile(&tile_vector[0]);
 			int tile_count = tileCount();
-			for (int tile_idx = 0; tile_idx < tile_count; tile_idx++) {
-				grTileSprite tile = getTile(tile_idx);
-				if (tile == grTileSprite(&tile_vector[0])) {
-					tile_id = tile_idx;
-					break;
-				}
-			}
 
 			if (tile_id == -1) {
 				uint32 sz = GR_TILE_SPRITE_SIZE;
@@ -179,12 +202,121 @@ void grTileAnimation::addFrame(const uint32 *frame_data) {
 				_tileData.insert(_tileData.end(), tile_vector.begin(), tile_vector.end());
 				_tileOffsets.push_back(offs + sz);
 				_frameIndex.push_back(tile_count);
+				_tileTypes.push_back(grTileSprite::classify(&tile_vector[0]));
+
+				indexTile(tile_count, &tile_vector[0]);
 			} else
 				_frameIndex.push_back(tile_id);
 		}
 	}
 }
 
+uint64 grTileAnimation::tileHash(const uint32 *tile_data) {
+	uint64 hash = 0xCBF29CE484222325ULL;
+	for (int i = 0; i < GR_TILE_SPRITE_SIZE; i++) {
+		hash ^= tile_data[i];
+		hash *= 0x100000001B3ULL;
+		hash ^= hash >> 29;
+	}
+
+	return hash;
+}
+
+uint32 grTileAnimation::tileSum(const uint32 *tile_data) {
+	const byte *ptr = (const byte *)tile_data;
+
+	uint32 sum = 0;
+	for (int i = 0; i < GR_TILE_SPRITE_SIZE_BYTES; i++)
+		sum += ptr[i];
+
+	return sum;
+}
+
+void grTileAnimation::indexTile(int tile_index, const uint32 *tile_data) {
+	uint32 sum = tileSum(tile_data);
+	_tileSums.push_back(sum);
+
+	if (!_tileIndexTolerance) {
+		uint64 hash = tileHash(tile_data);
+		if (!_tileHashIndex.contains(hash))
+			_tileHashIndex[hash] = tile_index;
+	} else {
+		uint32 bucket = sum / (_tileIndexTolerance * GR_TILE_SPRITE_SIZE_BYTES);
+		if (bucket >= _tileSumBuckets.size())
+			_tileSumBuckets.resize(bucket + 1);
+
+		_tileSumBuckets[bucket].push_back(tile_index);
+	}
+}
+
+int grTileAnimation::findTile(const uint32 *tile_data) {
+	if (_tileIndexTolerance != grTileSprite::comprasionTolerance())
+		clearTileIndex();
+
+	// тайлы, добавленные не через addFrame(), индексируем при первом поиске
+	int tile_count = tileCount();
+	for (int i = _tileSums.size(); i < tile_count; i++)
+		indexTile(i, getTile(i).data());
+
+	grTileSprite tile(tile_data);
+
+	if (!_tileIndexTolerance) {
+		TileHashIndex::const_iterator it = _tileHashIndex.find(tileHash(tile_data));
+		if (it == _tileHashIndex.end())
+			return -1;
+
+		if (getTile(it->_value) == tile)
+			return it->_value;
+
+		// коллизия хэша - ищем перебором
+		for (int i = 0; i < tile_count; i++) {
+			if (getTile(i) == tile)
+				return i;
+		}
+
+		return -1;
+	}
+
+	// при ненулевой толерантности суммы байтов похожих тайлов отличаются
+	// не больше чем на толерантность * размер тайла, т.е. тайлы лежат в соседних группах;
+	// как и при переборе, выбираем совпадающий тайл с наименьшим номером
+	uint32 max_delta = _tileIndexTolerance * GR_TILE_SPRITE_SIZE_BYTES;
+	uint32 sum = tileSum(tile_data);
+	int bucket = sum / max_delta;
+
+	int tile_id = -1;
+	for (int b = MAX(bucket - 1, 0); b <= bucket + 1 && b < (int)_tileSumBuckets.size(); b++) {
+		const TileList &list = _tileSumBuckets[b];
+		for (TileList::const_iterator it = list.begin(); it != list.end(); ++it) {
+			if (tile_id != -1 && (int)*it >= tile_id)
+				break;
+
+			uint32 tile_sum = _tileSums[*it];
+			if ((tile_sum > sum ? tile_sum - sum : sum - tile_sum) > max_delta)
+				continue;
+
+			if (getTile(*it) == tile) {
+				tile_id = *it;
+				break;
+			}
+		}
+	}
+
+	return tile_id;
+}
+
+void grTileAnimation::clearTileIndex() {
+	_tileIndexTolerance = grTileSprite::comprasionTolerance();
+
+	_tileHashIndex.clear(true);
+
+	_tileSums.clear();
+	TileList(_tileSums).swap(_tileSums);
+
+	_tileSumBuckets.clear();
+	Std::vector<TileList>(_tileSumBuckets).swap(_tileSumBuckets);
+}
+
 bool grTileAnimation::load(Common::SeekableReadStream *fh) {
 
 	debugC(7, kDebugLoad, "grTileAnimation::load(): pos start: %lu", fh->pos());
@@ -200,6 +332,7 @@ bool grTileAnimation::load(Common::SeekableReadStream *fh) {
 		_frameTileSize.x, _frameTileSize.y, size);
 
 	_compression = grTileCompressionMethod(size);
+	_cacheID = grTileCache::newOwnerID();
 
 	size = fh->readUint32LE();
 	_frameIndex.resize(size);
@@ -222,9 +355,32 @@ bool grTileAnimation::load(Common::SeekableReadStream *fh) {
 		_tileData[i] = fh->readUint32LE();
 	}
 
+	classifyTiles();
+
 	return true;
 }
 
+void grTileAnimation::classifyTiles() {
+	int count = tileCount();
+
+	_tileTypes.resize(count);
+
+	uint32 tile_buf[GR_TILE_SPRITE_SIZE];
+	for (int i = 0; i < count; i++) {
+		const uint32 *data = &*_tileData.begin() + _tileOffsets[i];
+
+		if (_compression != TILE_UNCOMPRESSED) {
+			if (!grTileSprite::uncompress(data, GR_TILE_SPRITE_SIZE, tile_buf, _compression)) {
+				_tileTypes[i] = TILE_MIXED;
+				continue;
+			}
+			data = tile_buf;
+		}
+
+		_tileTypes[i] = grTileSprite::classify(data);
+	}
+}
+
 void grTileAnimation::drawFrame(const Vect2i &position, int32 frame_index, int32 mode) const {
 	Vect2i pos0 = position - _frameSize / 2;
 
@@ -244,12 +400,24 @@ void grTileAnimation::drawFrame(const Vect2i &position, int32 frame_index, int32
 
 	const uint32 *index_ptr = &_frameIndex[0] + _frameTileSize.x * _frameTileSize.y * frame_index;
 
+	// тайлы вне области отсечения (при частичной перерисовке это перерисовываемая область) и пустые тайлы не распаковываем
+	int clip_left, clip_top, clip_right, clip_bottom;
+	grDispatcher::instance()->getClip(clip_left, clip_top, clip_right, clip_bottom);
+
 	Vect2i pos = pos0;
 	for (int32 i = 0; i < _frameTileSize.y; i++) {
+		if (pos.y + GR_TILE_SPRITE_SIZE_Y <= clip_top || pos.y >= clip_bottom) {
+			index_ptr += _frameTileSize.x;
+			pos.y += dy;
+			continue;
+		}
+
 		pos.x = pos0.x;
 
 		for (int32 j = 0; j < _frameTileSize.x; j++) {
-			grDispatcher::instance()->putTileSpr(pos.x, pos.y, getTile(*index_ptr++), _hasAlpha, mode);
+			int32 tile_index = *index_ptr++;
+			if (pos.x + GR_TILE_SPRITE_SIZE_X > clip_left && pos.x < clip_right && tileType(tile_index) != TILE_EMPTY)
+				grDispatcher::instance()->putTileSpr(pos.x, pos.y, getTile(tile_index), _hasAlpha, mode);
 			pos.x += dx;
 		}
 
@@ -258,24 +426,47 @@ void grTileAnimation::drawFrame(const Vect2i &position, int32 frame_index, int32
 }
 
 void grTileAnimation::drawFrame(const Vect2i &position, int frame_index, float angle, int mode) const {
-	byte *buf = (byte *)grDispatcher::instance()->temp_buffer(_frameSize.x * _frameSize.y * 4);
+	// указатели на тайлы кадра, 0 для пустых тайлов
+	static Std::vector<const uint32 *> tiles;
 
-	const uint32 *index_ptr = &_frameIndex[0] + _frameTileSize.x * _frameTileSize.y * frame_index;
+	// тайлы, не поместившиеся в кэш, память освобождается сразу после вывода
+	TileData overflow_data;
+	int overflow_count = 0;
 
-	for (int i = 0; i < _frameTileSize.y; i++) {
-		for (int j = 0; j < _frameTileSize.x; j++) {
-			byte *buf_ptr = buf + (i * _frameSize.x + j) * 4;
-			const byte *data_ptr = (const byte *)getTile(*index_ptr++).data();
-			int dx = MIN(_frameSize.x - j * GR_TILE_SPRITE_SIZE_X, GR_TILE_SPRITE_SIZE_X) * 4;
-			for (int k = 0; k < GR_TILE_SPRITE_SIZE_Y; k++) {
-				memcpy(buf_ptr, data_ptr, dx);
-				data_ptr += GR_TILE_SPRITE_SIZE_X * 4;
-				buf_ptr += _frameSize.x * 4;
+	uint32 tile_buf[GR_TILE_SPRITE_SIZE];
+
+	int count = _frameTileSize.x * _frameTileSize.y;
+	const uint32 *index_ptr = &_frameIndex[0] + count * frame_index;
+
+	tiles.resize(count);
+
+	// тайлы кадра не должны вытеснять друг друга, пока кадр не выведен
+	grTileCache::instance().pin();
+
+	for (int i = 0; i < count; i++) {
+		uint32 tile_index = index_ptr[i];
+
+		if (tileType(tile_index) == TILE_EMPTY) {
+			tiles[i] = 0;
+		} else if (_compression == TILE_UNCOMPRESSED) {
+			tiles[i] = &*_tileData.begin() + _tileOffsets[tile_index];
+		} else {
+			const uint32 *tile = unpackTile(tile_index, tile_buf);
+			if (tile == tile_buf) {
+				if (overflow_data.empty())
+					overflow_data.resize(count * GR_TILE_SPRITE_SIZE);
+
+				uint32 *buf = &overflow_data[overflow_count++ * GR_TILE_SPRITE_SIZE];
+				memcpy(buf, tile_buf, GR_TILE_SPRITE_SIZE_BYTES);
+				tile = buf;
 			}
+			tiles[i] = tile;
 		}
 	}
 
-	grDispatcher::instance()->putSpr_rot(position, _frameSize, buf, _hasAlpha, mode, angle);
+	grDispatcher::instance()->putTileSpr_rot(position, _frameSize, &tiles[0], _frameTileSize, _hasAlpha, mode, angle);
+
+	grTileCache::instance().unpin();
 }
 
 } // namespace QDEngine
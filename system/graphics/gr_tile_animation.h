@@ -23,6 +23,8 @@
 #ifndef QDENGINE_SYSTEM_GRAPHICS_GR_TILE_ANIMATION_H
 #define QDENGINE_SYSTEM_GRAPHICS_GR_TILE_ANIMATION_H
 
+#include "common/hashmap.h"
+
 #include "qdengine/xmath.h"
 #include "qdengine/system/graphics/gr_tile_sprite.h"
 
@@ -72,6 +74,9 @@ public:
 	void drawFrame(const Vect2i &position, int frame_index, int mode = 0) const;
 	void drawFrame(const Vect2i &position, int frame_index, float angle, int mode = 0) const;
 
+	/// Размер кэша распакованных тайлов в байтах, общий для всех анимаций.
+	static void setTileCacheSize(uint32 size);
+
 	static void setProgressHandler(CompressionProgressHandler handler, void *context) {
 		_progressHandler = handler;
 		_progressHandlerContext = context;
@@ -106,6 +111,49 @@ private:
 	/// данные тайлов
 	TileData _tileData;
 
+	typedef Std::vector<byte> TileTypes;
+	/// типы тайлов по прозрачности, см. grTileType
+	TileTypes _tileTypes;
+
+	/// номер анимации в кэше распакованных тайлов
+	uint32 _cacheID;
+
+	/// Распакованный тайл из кэша.
+	/**
+	Если тайл не помещается в кэш, он распаковывается в buf.
+	*/
+	const uint32 *unpackTile(int tile_index, uint32 *buf) const;
+
+	struct TileHashFunc {
+		uint operator()(uint64 hash) const {
+			return (uint)(hash ^ (hash >> 32));
+		}
+	};
+	typedef Common::HashMap<uint64, uint32, TileHashFunc> TileHashIndex;
+	typedef Std::vector<uint32> TileList;
+
+	/// индекс для поиска одинаковых тайлов в addFrame()
+	/// при нулевой толерантности сравнения - хэш данных тайла -> номер тайла
+	TileHashIndex _tileHashIndex;
+	/// суммы байтов данных тайлов
+	TileList _tileSums;
+	/// при ненулевой толерантности - тайлы, сгруппированные по суммам байтов
+	Std::vector<TileList> _tileSumBuckets;
+	/// толерантность, с которой построен индекс
+	uint32 _tileIndexTolerance;
+
+	static uint64 tileHash(const uint32 *tile_data);
+	static uint32 tileSum(const uint32 *tile_data);
+
+	grTileType tileType(int tile_index) const {
+		return (tile_index < (int)_tileTypes.size()) ? grTileType(_tileTypes[tile_index]) : TILE_MIXED;
+	}
+	void classifyTiles();
+
+	void indexTile(int tile_index, const uint32 *tile_data);
+	int findTile(const uint32 *tile_data);
+	void clearTileIndex();
+
 	static CompressionProgressHandler _progressHandler;
 	static void *_progressHandlerContext;
 };
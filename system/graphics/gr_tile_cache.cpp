@@ -0,0 +1,72 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "qdengine/qdengine.h"
+#include "qdengine/system/graphics/gr_tile_cache.h"
+
+
+namespace QDEngine {
+
+grTileCache grTileCache::_instance;
+uint32 grTileCache::_ownerIDCounter = 0;
+
+grTileCache::grTileCache() : qdMemoryCache("tiles") {
+}
+
+grTileCache::~grTileCache() {
+	clear();
+}
+
+const uint32 *grTileCache::find(uint32 owner_id, uint32 tile_index) {
+	TileMap::const_iterator it = _tileMap.find(makeKey(owner_id, tile_index));
+	if (it == _tileMap.end()) {
+		miss();
+		return 0;
+	}
+
+	hit(it->_value);
+	return it->_value->data;
+}
+
+uint32 *grTileCache::insert(uint32 owner_id, uint32 tile_index) {
+	if (!reserve(sizeof(TileEntry)))
+		return 0;
+
+	TileEntry *p = new TileEntry;
+	p->key = makeKey(owner_id, tile_index);
+	p->size = sizeof(TileEntry);
+
+	_tileMap[p->key] = p;
+	qdMemoryCache::insert(p);
+
+	return p->data;
+}
+
+void grTileCache::detach(Entry *p) {
+	_tileMap.erase(static_cast<TileEntry *>(p)->key);
+}
+
+void grTileCache::detachAll() {
+	_tileMap.clear(true);
+}
+
+} // namespace QDEngine
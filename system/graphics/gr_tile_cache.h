@@ -0,0 +1,90 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef QDENGINE_SYSTEM_GRAPHICS_GR_TILE_CACHE_H
+#define QDENGINE_SYSTEM_GRAPHICS_GR_TILE_CACHE_H
+
+#include "common/hashmap.h"
+
+#include "qdengine/qdcore/qd_memory_cache.h"
+#include "qdengine/system/graphics/gr_tile_sprite.h"
+
+namespace QDEngine {
+
+//! Кэш распакованных тайлов.
+/**
+Общий для всех тайловых анимаций, ограничен по памяти.
+Тайлы ключуются номером владельца (см. newOwnerID()) и номером тайла.
+*/
+class grTileCache : public qdMemoryCache {
+public:
+	grTileCache();
+	~grTileCache();
+
+	static grTileCache &instance() {
+		return _instance;
+	}
+
+	/// Новый номер владельца тайлов.
+	/**
+	Меняется при изменении данных анимации,
+	старые тайлы при этом просто вытесняются со временем.
+	*/
+	static uint32 newOwnerID() {
+		return ++_ownerIDCounter;
+	}
+
+	/// Возвращает распакованный тайл или 0, если его нет в кэше.
+	const uint32 *find(uint32 owner_id, uint32 tile_index);
+	/// Выделяет в кэше место под тайл, 0 если кэш выключен или заполнен закрепленными тайлами.
+	uint32 *insert(uint32 owner_id, uint32 tile_index);
+
+private:
+	struct TileEntry : public Entry {
+		uint64 key;
+		uint32 data[GR_TILE_SPRITE_SIZE];
+	};
+
+	struct KeyHash {
+		uint operator()(uint64 key) const {
+			return (uint)(key ^ (key >> 32) * 2654435761U);
+		}
+	};
+
+	typedef Common::HashMap<uint64, TileEntry *, KeyHash> TileMap;
+
+	TileMap _tileMap;
+
+	void detach(Entry *p);
+	void detachAll();
+
+	static uint64 makeKey(uint32 owner_id, uint32 tile_index) {
+		return ((uint64)owner_id << 32) | tile_index;
+	}
+
+	static grTileCache _instance;
+	static uint32 _ownerIDCounter;
+};
+
+} // namespace QDEngine
+
+#endif // QDENGINE_SYSTEM_GRAPHICS_GR_TILE_CACHE_H
@@ -97,6 +97,9 @@ bool decodeRLE(const uint32 *in_data, uint32 *out_data) {
 }; // namespace tile_compress
 
 void grDispatcher::putTileSpr(int x, int y, const grTileSprite &sprite, bool has_alpha, int mode) {
+	if (sprite.type() == TILE_EMPTY)
+		return;
+
 	int px = 0;
 	int py = 0;
 
@@ -122,6 +125,22 @@ void grDispatcher::putTileSpr(int x, int y, const grTileSprite &sprite, bool has
 
 	const byte *data_ptr = (const byte *)(sprite.data() + px + py * GR_TILE_SPRITE_SIZE_X);
 
+	if (sprite.type() == TILE_OPAQUE) {
+		for (int i = 0; i < psy; i++) {
+			uint16 *scr_buf = reinterpret_cast<uint16 *>(_screenBuf->getBasePtr(x, y));
+			const byte *data_line = data_ptr;
+
+			for (int j = 0; j < psx; j++) {
+				*scr_buf = make_rgb565u(data_line[2], data_line[1], data_line[0]);
+				scr_buf += dx;
+				data_line += 4;
+			}
+			data_ptr += GR_TILE_SPRITE_SIZE_X * 4;
+			y += dy;
+		}
+		return;
+	}
+
 	for (int i = 0; i < psy; i++) {
 		uint16 *scr_buf = reinterpret_cast<uint16 *>(_screenBuf->getBasePtr(x, y));
 		const byte *data_line = data_ptr;
@@ -142,7 +161,75 @@ void grDispatcher::putTileSpr(int x, int y, const grTileSprite &sprite, bool has
 	}
 }
 
-grTileSprite::grTileSprite(const uint32 *data_ptr) : _data(data_ptr) {
+void grDispatcher::putTileSpr_rot(const Vect2i &pos, const Vect2i &size, const uint32 *const *tiles, const Vect2i &tiles_size, bool has_alpha, int mode, float angle) {
+	RotateParams prm;
+	if (!rotate_setup(pos, size, angle, true, prm))
+		return;
+
+	for (int y = 0; y <= prm.sy; y++) {
+		int x_begin, x_end, xx, yy;
+		if (!rotate_span(prm, y, x_begin, x_end, xx, yy))
+			continue;
+
+		uint16 *screen_ptr = reinterpret_cast<uint16 *>(_screenBuf->getBasePtr(prm.x0 + x_begin, prm.y0 + y));
+
+		for (int x = x_begin; x <= x_end; x++) {
+			int xb = xx >> 16;
+			int yb = yy >> 16;
+
+			if (mode & GR_FLIP_HORIZONTAL)
+				xb = size.x - xb - 1;
+			if (mode & GR_FLIP_VERTICAL)
+				yb = size.y - yb - 1;
+
+			int tx = xb >> GR_TILE_SPRITE_SIZE_SHIFT;
+			int ty = yb >> GR_TILE_SPRITE_SIZE_SHIFT;
+
+			const uint32 *tile = (tx < tiles_size.x && ty < tiles_size.y) ? tiles[ty * tiles_size.x + tx] : 0;
+			if (tile) {
+				const byte *data_ptr = (const byte *)(tile + ((yb & (GR_TILE_SPRITE_SIZE_Y - 1)) << GR_TILE_SPRITE_SIZE_SHIFT) + (xb & (GR_TILE_SPRITE_SIZE_X - 1)));
+
+				if (has_alpha) {
+					uint32 a = data_ptr[3];
+					if (a != 255) {
+						if (a)
+							*screen_ptr = alpha_blend_565(make_rgb565u(data_ptr[2], data_ptr[1], data_ptr[0]), *screen_ptr, a);
+						else
+							*screen_ptr = make_rgb565u(data_ptr[2], data_ptr[1], data_ptr[0]);
+					}
+				} else if (data_ptr[0] || data_ptr[1] || data_ptr[2])
+					*screen_ptr = make_rgb565u(data_ptr[2], data_ptr[1], data_ptr[0]);
+			}
+
+			xx += prm.cos_a;
+			yy -= prm.sin_a;
+
+			screen_ptr++;
+		}
+	}
+}
+
+grTileSprite::grTileSprite(const uint32 *data_ptr, grTileType type) : _data(data_ptr), _type(type) {
+}
+
+grTileType grTileSprite::classify(const uint32 *data_ptr) {
+	const byte *ptr = (const byte *)data_ptr + 3;
+
+	int transparent = 0;
+	int opaque = 0;
+	for (int i = 0; i < GR_TILE_SPRITE_SIZE; i++, ptr += 4) {
+		if (*ptr == 255)
+			transparent++;
+		else if (!*ptr)
+			opaque++;
+	}
+
+	if (transparent == GR_TILE_SPRITE_SIZE)
+		return TILE_EMPTY;
+	if (opaque == GR_TILE_SPRITE_SIZE)
+		return TILE_OPAQUE;
+
+	return TILE_MIXED;
 }
 
 bool grTileSprite::operator == (const grTileSprite &sprite) const {
@@ -38,13 +38,20 @@ enum grTileCompressionMethod {
 	TILE_COMPRESS_LZ77
 };
 
+/// Тип тайла по прозрачности пикселов.
+enum grTileType {
+	TILE_MIXED,     ///< есть и прозрачные или полупрозрачные, и непрозрачные пикселы
+	TILE_EMPTY,     ///< все пикселы прозрачные
+	TILE_OPAQUE     ///< все пикселы непрозрачные
+};
+
 /// Тайл-спрайт
 
 /// Квадратный 32х битный спрайт фиксированного размера.
 /// Данные внешние.
 class grTileSprite {
 public:
-	grTileSprite(const uint32 *data_ptr = 0);
+	grTileSprite(const uint32 *data_ptr = 0, grTileType type = TILE_MIXED);
 
 	bool operator == (const grTileSprite &sprite) const;
 
@@ -56,6 +63,13 @@ public:
 		return _data;
 	}
 
+	grTileType type() const {
+		return _type;
+	}
+
+	/// Определяет тип тайла по альфа-каналу данных.
+	static grTileType classify(const uint32 *data_ptr);
+
 	static uint32 comprasionTolerance() {
 		return _comprasionTolerance;
 	}
@@ -69,6 +83,7 @@ public:
 private:
 
 	const uint32 *_data;
+	grTileType _type;
 
 	/// толерантность побайтового сравнения данных, [0, 255]
 	static uint32 _comprasionTolerance;
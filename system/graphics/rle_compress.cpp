@@ -38,17 +38,29 @@ bool operator == (const rleBuffer &buf1, const rleBuffer &buf2) {
 	if (!(buf1._header == buf2._header)) return false;
 	if (!(buf1._data == buf2._data)) return false;
 
+	if (buf1._is_native != buf2._is_native) return false;
+	if (!(buf1._native_offset == buf2._native_offset)) return false;
+	if (!(buf1._native_data == buf2._native_data)) return false;
+
 	return true;
 }
 
-rleBuffer::rleBuffer() : _bits_per_pixel(32) {
+rleBuffer::rleBuffer() : _bits_per_pixel(32),
+	_is_native(false),
+	_native_alpha(false),
+	_seek_line_points(-1) {
 }
 
 rleBuffer::rleBuffer(const rleBuffer &buf) : _header_offset(buf._header_offset),
 	_data_offset(buf._data_offset),
 	_header(buf._header),
 	_data(buf._data),
-	_bits_per_pixel(buf._bits_per_pixel) {
+	_bits_per_pixel(buf._bits_per_pixel),
+	_is_native(buf._is_native),
+	_native_alpha(buf._native_alpha),
+	_native_offset(buf._native_offset),
+	_native_data(buf._native_data),
+	_seek_line_points(-1) {
 }
 
 rleBuffer::~rleBuffer() {
@@ -57,6 +69,9 @@ rleBuffer::~rleBuffer() {
 	_header.clear();
 
 	_data.clear();
+
+	clear_native();
+	clear_seek_index();
 }
 
 rleBuffer &rleBuffer::operator = (const rleBuffer &buf) {
@@ -70,10 +85,20 @@ rleBuffer &rleBuffer::operator = (const rleBuffer &buf) {
 
 	_bits_per_pixel = buf._bits_per_pixel;
 
+	_is_native = buf._is_native;
+	_native_alpha = buf._native_alpha;
+	_native_offset = buf._native_offset;
+	_native_data = buf._native_data;
+
+	clear_seek_index();
+
 	return *this;
 }
 
 bool rleBuffer::encode(int sx, int sy, const byte *buf) {
+	clear_native();
+	clear_seek_index();
+
 	_header_offset.resize(sy);
 	_data_offset.resize(sy);
 
@@ -124,6 +149,9 @@ bool rleBuffer::encode(int sx, int sy, const byte *buf) {
 }
 
 bool rleBuffer::decode_line(int y, byte *out_buf) const {
+	if (_is_native)
+		return decode_native_line(y, out_buf);
+
 	const char *header_ptr = &*(_header.begin() + _header_offset[y]);
 	const uint32 *data_ptr = &*(_data.begin() + _data_offset[y]);
 
@@ -149,42 +177,177 @@ bool rleBuffer::decode_line(int y, byte *out_buf) const {
 	return true;
 }
 
-bool rleBuffer::decode_pixel(int x, int y, uint32 &pixel) {
-	const char *header_ptr = &*(_header.begin() + _header_offset[y]);
-	const uint32 *data_ptr = &*(_data.begin() + _data_offset[y]);
-
-	int xx = 0;
-	char count = *header_ptr++;
-
-	while (xx + abs(count) < x) {
-		if (count > 0) {
-			data_ptr++;
-		} else {
-			count = -count;
-			data_ptr += count;
+bool rleBuffer::decode_pixel(int x, int y, uint32 &pixel) const {
+	int xx;
+
+	if (_is_native) {
+		const uint16 *ptr = native_seek(x, y, xx);
+		uint16 run = *ptr++;
+
+		if (!(run & NATIVE_REPEAT))
+			ptr += (run & NATIVE_KIND_MASK) == NATIVE_ALPHA ? (x - xx) * 2 : x - xx;
+
+		byte *pixel_buf = reinterpret_cast<byte *>(&pixel);
+		switch (run & NATIVE_KIND_MASK) {
+		case NATIVE_OPAQUE:
+		case NATIVE_ALPHA:
+			grDispatcher::split_rgb565u(ptr[0], pixel_buf[2], pixel_buf[1], pixel_buf[0]);
+			if (!pixel_buf[0] && !pixel_buf[1] && !pixel_buf[2])
+				pixel_buf[0] = 1;
+			pixel_buf[3] = ((run & NATIVE_KIND_MASK) == NATIVE_ALPHA) ? ptr[1] : 0;
+			break;
+		default:
+			pixel = _native_alpha ? 0xFF000000 : 0;
+			break;
 		}
-		xx += count;
-		count = *header_ptr++;
+
+		return true;
 	}
 
-	if (count > 0) {
+	const char *header_ptr;
+	const uint32 *data_ptr;
+	seek(x, y, header_ptr, data_ptr, xx);
+
+	if (*header_ptr > 0)
 		pixel = *data_ptr;
+	else
+		pixel = data_ptr[x - xx];
+
+	return true;
+}
+
+void rleBuffer::seek(int x, int y, const char *&header, const uint32 *&data, int &run_x) const {
+	// от начала строки индекс не нужен, строим его только при первом поиске внутри строки
+	int point = x / SEEK_STEP;
+	if (point) {
+		if (_seek_line_points < 0)
+			build_seek_index();
+		if (point > _seek_line_points)
+			point = _seek_line_points;
+	}
+
+	if (point) {
+		const SeekPoint &pt = _seek_index[y * _seek_line_points + point - 1];
+		header = &*(_header.begin() + pt.header_offset);
+		data = &*(_data.begin() + pt.data_offset);
+		run_x = pt.x;
 	} else {
-		data_ptr += x - xx;
-		pixel = *data_ptr;
+		header = header_ptr(y);
+		data = data_ptr(y);
+		run_x = 0;
 	}
 
-	return true;
+	for (;;) {
+		char count = *header;
+		int len = abs(count);
+		if (run_x + len > x)
+			return;
+
+		run_x += len;
+		data += (count > 0) ? 1 : len;
+		header++;
+	}
+}
+
+const uint16 *rleBuffer::native_seek(int x, int y, int &run_x) const {
+	int point = x / SEEK_STEP;
+	if (point) {
+		if (_seek_line_points < 0)
+			build_seek_index();
+		if (point > _seek_line_points)
+			point = _seek_line_points;
+	}
+
+	const uint16 *ptr;
+	if (point) {
+		const SeekPoint &pt = _seek_index[y * _seek_line_points + point - 1];
+		ptr = &*(_native_data.begin() + pt.header_offset);
+		run_x = pt.x;
+	} else {
+		ptr = native_ptr(y);
+		run_x = 0;
+	}
+
+	for (;;) {
+		int len = *ptr & NATIVE_LENGTH_MASK;
+		if (run_x + len > x)
+			return ptr;
+
+		run_x += len;
+		ptr += native_run_data_size(*ptr) + 1;
+	}
+}
+
+void rleBuffer::build_seek_index() const {
+	int sx = line_length();
+	int sy = _is_native ? _native_offset.size() : _header_offset.size();
+
+	_seek_index.clear();
+	_seek_line_points = (sx > SEEK_STEP) ? (sx - 1) / SEEK_STEP : 0;
+	if (!_seek_line_points || !sy)
+		return;
+
+	_seek_index.resize(_seek_line_points * sy);
+
+	SeekPoint *pt = &_seek_index[0];
+	for (int y = 0; y < sy; y++) {
+		int next_x = SEEK_STEP;
+		int xx = 0;
+
+		if (_is_native) {
+			uint32 offset = _native_offset[y];
+			while (next_x < sx) {
+				int len = _native_data[offset] & NATIVE_LENGTH_MASK;
+				while (next_x < xx + len && next_x < sx) {
+					pt->header_offset = offset;
+					pt->data_offset = 0;
+					pt->x = xx;
+					pt++;
+					next_x += SEEK_STEP;
+				}
+				xx += len;
+				offset += native_run_data_size(_native_data[offset]) + 1;
+			}
+		} else {
+			uint32 header_offset = _header_offset[y];
+			uint32 data_offset = _data_offset[y];
+			while (next_x < sx) {
+				char count = _header[header_offset];
+				int len = abs(count);
+				while (next_x < xx + len && next_x < sx) {
+					pt->header_offset = header_offset;
+					pt->data_offset = data_offset;
+					pt->x = xx;
+					pt++;
+					next_x += SEEK_STEP;
+				}
+				xx += len;
+				header_offset++;
+				data_offset += (count > 0) ? 1 : len;
+			}
+		}
+	}
+}
+
+void rleBuffer::clear_seek_index() {
+	_seek_line_points = -1;
+	_seek_index.clear();
+	Std::vector<SeekPoint>(_seek_index).swap(_seek_index);
 }
 
 uint32 rleBuffer::size() {
-	return _data.size() * sizeof(uint32) + _data_offset.size() + _header_offset.size() * sizeof(uint32) + _header.size();
+	return _data.size() * sizeof(uint32) + _data_offset.size() + _header_offset.size() * sizeof(uint32) + _header.size()
+		+ _native_data.size() * sizeof(uint16) + _native_offset.size() * sizeof(uint32)
+		+ _seek_index.size() * sizeof(SeekPoint);
 }
 
 bool rleBuffer::convert_data(int bits_per_pixel) {
 	if (_bits_per_pixel == bits_per_pixel)
 		return true;
 
+	if (_is_native)
+		return false;
+
 	int sz = _data.size();
 
 	switch (_bits_per_pixel) {
@@ -264,7 +427,18 @@ void rleBuffer::resize_buffers() {
 		_buffer1.resize(len);
 }
 
-int rleBuffer::line_length() {
+int rleBuffer::line_length() const {
+	if (_is_native) {
+		if (_native_offset.empty()) return 0;
+
+		int len = 0;
+		const uint16 *end = native_end_ptr(0);
+		for (const uint16 *ptr = native_ptr(0); ptr < end; ptr += native_run_data_size(*ptr) + 1)
+			len += *ptr & NATIVE_LENGTH_MASK;
+
+		return len;
+	}
+
 	if (_header_offset.empty()) return 0;
 
 	int sz = (_header_offset.size() > 1) ? _header_offset[1] : _header.size();
@@ -286,6 +460,9 @@ int rleBuffer::line_header_length(int line_num) const {
 
 
 bool rleBuffer::load(Common::SeekableReadStream *fh) {
+	clear_native();
+	clear_seek_index();
+
 	int32 sz = fh->readUint32LE();
 	_header_offset.resize(sz);
 
@@ -320,4 +497,161 @@ bool rleBuffer::load(Common::SeekableReadStream *fh) {
 	return true;
 }
 
+namespace {
+
+inline uint16 native_kind(uint32 pixel, bool alpha_flag) {
+	if (alpha_flag) {
+		uint32 a = pixel >> 24;
+		if (a == 255) return rleBuffer::NATIVE_SKIP;
+		return a ? rleBuffer::NATIVE_ALPHA : rleBuffer::NATIVE_OPAQUE;
+	}
+
+	return pixel ? rleBuffer::NATIVE_OPAQUE : rleBuffer::NATIVE_SKIP;
+}
+
+inline uint16 native_color(uint32 pixel) {
+	const byte *p = reinterpret_cast<const byte *>(&pixel);
+	return grDispatcher::make_rgb565u(p[2], p[1], p[0]);
+}
+
+inline bool native_equal(uint32 pixel0, uint32 pixel1, uint16 kind) {
+	if (native_color(pixel0) != native_color(pixel1)) return false;
+	return kind != rleBuffer::NATIVE_ALPHA || (pixel0 >> 24) == (pixel1 >> 24);
+}
+
+inline void native_push(Std::vector<uint16> &data, uint32 pixel, uint16 kind) {
+	data.push_back(native_color(pixel));
+	if (kind == rleBuffer::NATIVE_ALPHA)
+		data.push_back(pixel >> 24);
+}
+
+} // namespace
+
+bool rleBuffer::convert_native(bool alpha_flag) {
+	if (_is_native)
+		return true;
+
+	if (_bits_per_pixel != 32 || _header_offset.empty())
+		return false;
+
+	int sx = line_length();
+	int sy = _header_offset.size();
+
+	Std::vector<uint32> line(sx);
+
+	_native_offset.resize(sy);
+	_native_data.clear();
+	_native_data.reserve(_data.size() + _header.size());
+
+	for (int y = 0; y < sy; y++) {
+		_native_offset[y] = _native_data.size();
+		decode_line(y, reinterpret_cast<byte *>(&line[0]));
+
+		int x = 0;
+		while (x < sx) {
+			uint16 kind = native_kind(line[x], alpha_flag);
+
+			int end = x + 1;
+			while (end < sx && end - x < NATIVE_LENGTH_MASK && native_kind(line[end], alpha_flag) == kind)
+				end++;
+
+			if (kind == NATIVE_SKIP) {
+				_native_data.push_back(kind | (end - x));
+				x = end;
+				continue;
+			}
+
+			// серии из трёх и более одинаковых пикселов пишем как повтор, остальное - как есть
+			while (x < end) {
+				int idx = x + 1;
+				while (idx < end && native_equal(line[idx], line[x], kind))
+					idx++;
+
+				if (idx - x >= 3) {
+					_native_data.push_back(kind | NATIVE_REPEAT | (idx - x));
+					native_push(_native_data, line[x], kind);
+				} else {
+					idx = x + 1;
+					while (idx < end) {
+						if (idx + 2 < end && native_equal(line[idx + 1], line[idx], kind) && native_equal(line[idx + 2], line[idx], kind))
+							break;
+						idx++;
+					}
+
+					_native_data.push_back(kind | (idx - x));
+					for (int i = x; i < idx; i++)
+						native_push(_native_data, line[i], kind);
+				}
+
+				x = idx;
+			}
+		}
+	}
+
+	Std::vector<uint16>(_native_data).swap(_native_data);
+
+	_header_offset.clear();
+	Std::vector<uint32>(_header_offset).swap(_header_offset);
+	_data_offset.clear();
+	Std::vector<uint32>(_data_offset).swap(_data_offset);
+	_header.clear();
+	Std::vector<char>(_header).swap(_header);
+	_data.clear();
+	Std::vector<uint32>(_data).swap(_data);
+
+	_is_native = true;
+	_native_alpha = alpha_flag;
+
+	clear_seek_index();
+
+	return true;
+}
+
+bool rleBuffer::decode_native_line(int y, byte *out_buf) const {
+	const uint16 *ptr = native_ptr(y);
+	const uint16 *end = native_end_ptr(y);
+
+	byte *out_ptr = out_buf;
+
+	while (ptr < end) {
+		uint16 run = *ptr++;
+		int count = run & NATIVE_LENGTH_MASK;
+		uint16 kind = run & NATIVE_KIND_MASK;
+
+		if (kind == NATIVE_SKIP) {
+			uint32 pixel = _native_alpha ? 0xFF000000 : 0;
+			for (int i = 0; i < count; i++) {
+				memcpy(out_ptr, &pixel, sizeof(uint32));
+				out_ptr += 4;
+			}
+			continue;
+		}
+
+		int step = (run & NATIVE_REPEAT) ? 0 : ((kind == NATIVE_ALPHA) ? 2 : 1);
+		const uint16 *data_ptr = ptr;
+		for (int i = 0; i < count; i++) {
+			grDispatcher::split_rgb565u(data_ptr[0], out_ptr[2], out_ptr[1], out_ptr[0]);
+			// чёрный непрозрачный пиксел не должен стать прозрачным
+			if (!out_ptr[0] && !out_ptr[1] && !out_ptr[2])
+				out_ptr[0] = 1;
+			out_ptr[3] = (kind == NATIVE_ALPHA) ? data_ptr[1] : 0;
+
+			out_ptr += 4;
+			data_ptr += step;
+		}
+
+		ptr += native_run_data_size(run);
+	}
+
+	return true;
+}
+
+void rleBuffer::clear_native() {
+	_is_native = false;
+	_native_alpha = false;
+
+	_native_offset.clear();
+	_native_data.clear();
+}
+
 } // namespace QDEngine
@@ -45,7 +45,7 @@ public:
 			return decode_line(y, &*_buffer0.begin());
 	}
 
-	bool decode_pixel(int x, int y, uint32 &pixel);
+	bool decode_pixel(int x, int y, uint32 &pixel) const;
 
 	static inline const byte *get_buffer(int buffer_id) {
 		if (buffer_id) return &*_buffer1.begin();
@@ -55,7 +55,7 @@ public:
 	void resize_buffers();
 
 	uint32 size();
-	int line_length();
+	int line_length() const;
 	int line_header_length(int line_num) const;
 
 	uint32 header_size() const {
@@ -72,10 +72,71 @@ public:
 		return &*(_data.begin() + _data_offset[y]);
 	}
 
+	/// Шаг индекса строк в пикселах.
+	enum { SEEK_STEP = 64 };
+
+	/// Поиск серии, содержащей пиксел x строки y.
+	/**
+	Возвращает указатели на заголовок и данные серии,
+	run_x - номер первого пиксела серии в строке.
+	Для длинных строк используется индекс, который строится при первом обращении.
+	*/
+	void seek(int x, int y, const char *&header, const uint32 *&data, int &run_x) const;
+	/// То же для данных в формате экрана, возвращает указатель на заголовок серии.
+	const uint16 *native_seek(int x, int y, int &run_x) const;
+
 	bool load(Common::SeekableReadStream *fh);
 
 	bool convert_data(int bits_per_pixel = 16);
 
+	/// Заголовок серии в формате экрана.
+	/**
+	Старшие два бита - тип серии, следующий бит - признак повтора,
+	остальные - длина серии в пикселах.
+	*/
+	enum {
+		NATIVE_SKIP         = 0 << 14,  ///< прозрачные пикселы, данных нет
+		NATIVE_OPAQUE       = 1 << 14,  ///< непрозрачные пикселы, по слову RGB565 на пиксел
+		NATIVE_ALPHA        = 2 << 14,  ///< полупрозрачные пикселы, по два слова (RGB565, альфа) на пиксел
+		NATIVE_KIND_MASK    = 3 << 14,
+		NATIVE_REPEAT       = 1 << 13,  ///< все пикселы серии одинаковые, данные одного пиксела
+		NATIVE_LENGTH_MASK  = NATIVE_REPEAT - 1
+	};
+
+	/// Перевод данных в формат экрана RGB565.
+	/**
+	Данные хранятся в виде серий с явно указанным типом (см. NATIVE_*),
+	непрозрачные серии копируются на экран без преобразования.
+	Исходные 32-битные данные после перевода освобождаются,
+	decode_line() и decode_pixel() продолжают работать.
+	*/
+	bool convert_native(bool alpha_flag);
+	bool is_native() const {
+		return _is_native;
+	}
+
+	const uint16 *native_ptr(int y = 0) const {
+		return &*(_native_data.begin() + _native_offset[y]);
+	}
+	const uint16 *native_end_ptr(int y) const {
+		if (y < (int)_native_offset.size() - 1)
+			return &*(_native_data.begin() + _native_offset[y + 1]);
+		return &*_native_data.begin() + _native_data.size();
+	}
+
+	/// Размер данных серии в словах, без заголовка.
+	static inline int native_run_data_size(uint16 run) {
+		int sz = (run & NATIVE_REPEAT) ? 1 : (run & NATIVE_LENGTH_MASK);
+		switch (run & NATIVE_KIND_MASK) {
+		case NATIVE_OPAQUE:
+			return sz;
+		case NATIVE_ALPHA:
+			return sz * 2;
+		default:
+			return 0;
+		}
+	}
+
 private:
 	Std::vector<uint32> _header_offset;
 	Std::vector<uint32> _data_offset;
@@ -85,6 +146,28 @@ private:
 
 	int _bits_per_pixel;
 
+	bool _is_native;
+	bool _native_alpha;
+	Std::vector<uint32> _native_offset;
+	Std::vector<uint16> _native_data;
+
+	bool decode_native_line(int y, byte *out_buf) const;
+	void clear_native();
+
+	/// Точка индекса строки - серия, содержащая пиксел с номером, кратным SEEK_STEP.
+	struct SeekPoint {
+		uint32 header_offset;  ///< смещение заголовка (для формата экрана - смещение в _native_data)
+		uint32 data_offset;
+		int32 x;               ///< номер первого пиксела серии
+	};
+
+	/// Количество точек индекса на строку, -1 если индекс ещё не построен.
+	mutable int _seek_line_points;
+	mutable Std::vector<SeekPoint> _seek_index;
+
+	void build_seek_index() const;
+	void clear_seek_index();
+
 	static Std::vector<byte> _buffer0;
 	static Std::vector<byte> _buffer1;
 